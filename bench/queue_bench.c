@@ -0,0 +1,149 @@
+// bench/queue_bench.c
+// Banc d'essai de la file : boîte d'arrivée lock-free (Queue) contre
+// l'ancienne file tout-mutex, avec P producteurs et un consommateur.
+//   ./bench/queue_bench [tâches par producteur]
+#include "queue.h"
+#include "heap.h"
+#include "task.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#define BATCH 64
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// ====== Référence : file protégée par un seul mutex ======
+typedef struct {
+    TaskHeap heap;
+    unsigned long next_seq;
+    pthread_mutex_t mutex;
+} MutexQueue;
+
+static int cmp_seq(const Task *a, const Task *b) {
+    return (a->seq > b->seq) - (a->seq < b->seq);
+}
+
+static void mq_enqueue(MutexQueue *q, Task *t) {
+    pthread_mutex_lock(&q->mutex);
+    t->seq = q->next_seq++;
+    heap_push(&q->heap, t);
+    pthread_mutex_unlock(&q->mutex);
+}
+
+// Comme l'ancien ordonnanceur : queue_is_empty puis dequeue, deux verrous
+static Task *mq_poll(MutexQueue *q) {
+    pthread_mutex_lock(&q->mutex);
+    int empty = q->heap.size == 0;
+    pthread_mutex_unlock(&q->mutex);
+    if (empty) return NULL;
+    pthread_mutex_lock(&q->mutex);
+    Task *t = heap_pop(&q->heap);
+    pthread_mutex_unlock(&q->mutex);
+    return t;
+}
+
+// ====== Scénario ======
+typedef struct {
+    int lockfree;
+    Queue *q;
+    MutexQueue *mq;
+    Task *tasks;
+    long n;
+    double elapsed; // temps passé à soumettre
+} Producer;
+
+static void *producer_main(void *arg) {
+    Producer *p = arg;
+    double t0 = now_sec();
+    for (long i = 0; i < p->n; i++) {
+        if (p->lockfree) enqueue(p->q, &p->tasks[i]);
+        else mq_enqueue(p->mq, &p->tasks[i]);
+    }
+    p->elapsed = now_sec() - t0;
+    return NULL;
+}
+
+static double run(int lockfree, int nprod, long per_prod, Task *tasks, double *submit_ns) {
+    Queue q;
+    MutexQueue mq;
+    queue_init(&q);
+    heap_init(&mq.heap, cmp_seq);
+    mq.next_seq = 0;
+    pthread_mutex_init(&mq.mutex, NULL);
+
+    long total = nprod * per_prod;
+    for (long i = 0; i < total; i++) tasks[i].heap_idx = -1;
+
+    Producer *prods = calloc((size_t)nprod, sizeof(Producer));
+    pthread_t *tids = calloc((size_t)nprod, sizeof(pthread_t));
+    if (!prods || !tids) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+
+    double t0 = now_sec();
+    for (int i = 0; i < nprod; i++) {
+        prods[i] = (Producer){ lockfree, &q, &mq, tasks + i * per_prod, per_prod, 0 };
+        pthread_create(&tids[i], NULL, producer_main, &prods[i]);
+    }
+    // Consommateur : le thread courant, comme l'ordonnanceur
+    Task *batch[BATCH];
+    long got = 0;
+    while (got < total) {
+        if (lockfree) {
+            got += dequeue_batch(&q, batch, BATCH);
+        } else if (mq_poll(&mq)) {
+            got++;
+        }
+    }
+    double elapsed = now_sec() - t0;
+
+    double submit = 0;
+    for (int i = 0; i < nprod; i++) {
+        pthread_join(tids[i], NULL);
+        submit += prods[i].elapsed;
+    }
+    *submit_ns = submit * 1e9 / total;
+
+    free(prods);
+    free(tids);
+    heap_destroy(&q.heap);
+    heap_destroy(&mq.heap);
+    pthread_mutex_destroy(&q.mutex);
+    pthread_mutex_destroy(&mq.mutex);
+    return elapsed;
+}
+
+int main(int argc, char **argv) {
+    long per_prod = argc > 1 ? atol(argv[1]) : 200000;
+    if (per_prod <= 0) per_prod = 200000;
+    const int prods[] = { 1, 2, 4, 8 };
+    int max_prod = prods[sizeof(prods) / sizeof(prods[0]) - 1];
+
+    Task *tasks = calloc((size_t)(max_prod * per_prod), sizeof(Task));
+    if (!tasks) {
+        perror("calloc");
+        return EXIT_FAILURE;
+    }
+
+    printf("%-11s %5s %12s %14s %14s\n", "file", "prod", "tâches", "débit (M/s)", "soumission (ns)");
+    for (size_t i = 0; i < sizeof(prods) / sizeof(prods[0]); i++) {
+        long total = prods[i] * per_prod;
+        for (int lockfree = 0; lockfree <= 1; lockfree++) {
+            double submit_ns;
+            double sec = run(lockfree, prods[i], per_prod, tasks, &submit_ns);
+            printf("%-11s %5d %12ld %14.2f %14.1f\n", lockfree ? "lock-free" : "mutex",
+                   prods[i], total, total / sec / 1e6, submit_ns);
+        }
+    }
+    free(tasks);
+    return EXIT_SUCCESS;
+}
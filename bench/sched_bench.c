@@ -0,0 +1,131 @@
+// bench/sched_bench.c
+// Banc d'essai de l'ordonnanceur complet : un gros lot de tâches synthétiques
+// passe par chaque algorithme (vrais processus, vraie boucle d'événements).
+// Mesures : mémoire par tâche en file, débit, latence de dispatch (de la tâche
+// prête sur un worker libre jusqu'au fils lancé), temps CPU et changements de
+// contexte du thread ordonnanceur par tâche ; puis des tâches de calcul plus
+// longues que le quantum sous RR pour le coût d'une préemption.
+//   ./bench/sched_bench [tâches par algorithme] [workers]
+#define _GNU_SOURCE    // RUSAGE_THREAD
+#include "scheduler.h"
+#include "queue.h"
+#include "task.h"
+#include "latency.h"
+#include "policy.h"
+#include "log.h"
+#include "tasks_impl.h"  // run_task_main
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>    // mallinfo2
+#include <time.h>
+#include <sys/resource.h>
+
+#define SPIN_TASKS 2
+#define SPIN_MS "1500"  // plus long que le quantum : au moins une préemption chacune
+
+int scheduler_running; // défini par main.c dans l'exécutable
+
+static const char *algo_names[ALG_COUNT] = { "fifo", "rr", "priority", "mlfq", "sjf", "edf", "fair" };
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static size_t heap_in_use(void) {
+    struct mallinfo2 mi = mallinfo2();
+    return mi.uordblks + mi.hblkhd;
+}
+
+static double cpu_sec(const struct rusage *ru) {
+    return ru->ru_utime.tv_sec + ru->ru_stime.tv_sec
+         + (ru->ru_utime.tv_usec + ru->ru_stime.tv_usec) / 1e6;
+}
+
+// Met n tâches type/param dans q, dans l'ordre de l'algorithme ; retourne
+// les octets de tas neufs qu'elles occupent (descripteurs et places dans le tas)
+static long fill_queue(Queue *q, algo_t alg, long n, task_type_t type, const char *param) {
+    size_t before = heap_in_use();
+    for (long i = 0; i < n; i++) {
+        Task *t = create_task(type, (int)(i % 8), param, NULL);
+        if (!t || enqueue(q, t) == -1) {
+            perror("create_task");
+            exit(EXIT_FAILURE);
+        }
+    }
+    // verse la boîte d'arrivée dans le tas, comme run_pool au démarrage
+    queue_set_order(q, policy_queue_order(alg));
+    return (long)(heap_in_use() - before);
+}
+
+typedef struct {
+    double wall;       // s
+    double sched_cpu;  // s, thread ordonnanceur
+    double child_cpu;  // s, fils récoltés
+    long csw;          // changements de contexte du thread ordonnanceur
+} RunStats;
+
+// quantum_ms = 0 : quantum par défaut de l'algorithme
+static RunStats run(algo_t alg, int quantum_ms, int workers, Queue *q) {
+    SchedulerConfig cfg = { alg, quantum_ms, workers, NULL, NULL, NULL, 0, 0, NULL };
+    struct rusage self0, self1, kids0, kids1;
+    getrusage(RUSAGE_THREAD, &self0);
+    getrusage(RUSAGE_CHILDREN, &kids0);
+    double t0 = now_sec();
+    run_scheduler(&cfg, q);
+    RunStats s;
+    s.wall = now_sec() - t0;
+    getrusage(RUSAGE_THREAD, &self1);
+    getrusage(RUSAGE_CHILDREN, &kids1);
+    s.sched_cpu = cpu_sec(&self1) - cpu_sec(&self0);
+    s.child_cpu = cpu_sec(&kids1) - cpu_sec(&kids0);
+    s.csw = (self1.ru_nvcsw - self0.ru_nvcsw) + (self1.ru_nivcsw - self0.ru_nivcsw);
+    return s;
+}
+
+int main(int argc, char **argv) {
+    // les tâches synthétiques relancent ce binaire (spawn_task)
+    if (argc > 1 && strcmp(argv[1], "--run-task") == 0) return run_task_main(argc - 2, argv + 2);
+    long n = argc > 1 ? atol(argv[1]) : 5000;
+    if (n <= 0) n = 5000;
+    int workers = argc > 2 ? atoi(argv[2]) : 0;
+    if (workers <= 0) workers = scheduler_default_workers();
+
+    Queue q;
+    queue_init(&q);
+    printf("%ld tâches « sleep 0 » par algorithme, %d worker(s) ; journal dans %s\n",
+           n, workers, LOGFILE);
+    printf("%-9s %10s %13s %13s %14s %10s\n", "algo", "tâches/s",
+           "dispatch p50", "dispatch p99", "CPU ord./tâche", "csw/tâche");
+    long bytes = 0;
+    for (int a = 0; a < ALG_COUNT; a++) {
+        // les lots suivants réutilisent les slabs et le tas du premier
+        long used = fill_queue(&q, (algo_t)a, n, TASK_SLEEP, "0");
+        if (a == 0) bytes = used;
+        RunStats s = run((algo_t)a, 0, workers, &q);
+        const Histogram *h = latency_histogram((algo_t)a, TASK_SLEEP, LAT_DISPATCH);
+        printf("%-9s %10.0f %10llu µs %10llu µs %11.1f µs %10.2f\n", algo_names[a],
+               n / s.wall, h ? hist_percentile(h, 50) : 0ULL,
+               h ? hist_percentile(h, 99) : 0ULL, s.sched_cpu * 1e6 / n, (double)s.csw / n);
+    }
+
+    printf("Mémoire par tâche en file : %.1f octets (descripteur de %zu octets, "
+           "place dans le tas, slabs)\n", (double)bytes / n, sizeof(Task));
+
+    // Préemptions RR : le temps réel non passé à calculer, rapporté aux passages
+    fill_queue(&q, ALG_RR, SPIN_TASKS, TASK_SPIN, SPIN_MS);
+    RunStats s = run(ALG_RR, 1000, 1, &q);
+    const Histogram *h = latency_histogram(ALG_RR, TASK_SPIN, LAT_DISPATCH);
+    long passes = h ? (long)h->count : 0;
+    printf("\nRR, %d tâches « spin %s » sur 1 worker (quantum 1 s) : %ld passages "
+           "(%ld préemptions), surcoût %.0f µs par passage, dispatch max %llu µs\n",
+           SPIN_TASKS, SPIN_MS, passes, passes - SPIN_TASKS,
+           passes ? (s.wall - s.child_cpu) * 1e6 / passes : 0.0, h ? h->max : 0ULL);
+
+    clear_queue(&q);
+    log_shutdown();
+    return EXIT_SUCCESS;
+}
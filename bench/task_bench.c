@@ -0,0 +1,94 @@
+// bench/task_bench.c
+// Banc d'essai des descripteurs : pool de tâches (slabs + chaînes en ligne)
+// contre l'ancien malloc + deux strdup, sur des lots créés puis libérés.
+//   ./bench/task_bench [tâches par lot]
+#include "task.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>    // offsetof
+#include <malloc.h>    // mallinfo2
+#include <time.h>
+
+#define ROUNDS 5
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static size_t heap_in_use(void) {
+    return mallinfo2().uordblks;
+}
+
+// ====== Référence : une allocation pour la tâche, une par chaîne ======
+// L'ancienne tâche s'arrêtait avant arena / inline_str : même taille, seuls
+// les champs touchés ici sont nommés
+typedef struct LegacyTask {
+    char *param1;
+    char *param2;
+    struct LegacyTask *next;
+    char rest[offsetof(Task, arena) - 3 * sizeof(char *)];
+} LegacyTask;
+
+static LegacyTask *legacy_create(const char *p1, const char *p2) {
+    LegacyTask *t = malloc(sizeof(LegacyTask));
+    if (!t) return NULL;
+    t->param1 = strdup(p1);
+    t->param2 = strdup(p2);
+    t->next = NULL;
+    return t;
+}
+
+static void legacy_free(LegacyTask *t) {
+    free(t->param1);
+    free(t->param2);
+    free(t);
+}
+
+int main(int argc, char **argv) {
+    long n = argc > 1 ? atol(argv[1]) : 100000;
+    if (n <= 0) n = 100000;
+    Task **tasks = malloc((size_t)n * sizeof(Task *));
+    LegacyTask **legacy = malloc((size_t)n * sizeof(LegacyTask *));
+    char (*paths)[2][64] = malloc((size_t)n * sizeof(*paths));
+    if (!tasks || !legacy || !paths) {
+        perror("malloc");
+        return EXIT_FAILURE;
+    }
+    for (long i = 0; i < n; i++) {
+        snprintf(paths[i][0], sizeof(paths[i][0]), "/home/user/videos/enregistrement-%06ld.mp4", i);
+        snprintf(paths[i][1], sizeof(paths[i][1]), "/home/user/audio/enregistrement-%06ld.mp3", i);
+    }
+
+    printf("%-8s %5s %10s %16s %16s\n", "alloc", "lot", "tâches", "création (ns)", "octets neufs/tâche");
+    for (int pool = 0; pool <= 1; pool++) {
+        for (int r = 0; r < ROUNDS; r++) {
+            size_t before = heap_in_use();
+            double t0 = now_sec();
+            for (long i = 0; i < n; i++) {
+                if (pool) tasks[i] = create_task(TASK_CONV_VIDEO, 0, paths[i][0], paths[i][1]);
+                else legacy[i] = legacy_create(paths[i][0], paths[i][1]);
+            }
+            double elapsed = now_sec() - t0;
+            size_t used = heap_in_use() - before;
+
+            // Fin du lot : tout est libéré d'un coup
+            if (pool) {
+                for (long i = 0; i + 1 < n; i++) tasks[i]->next = tasks[i + 1];
+                tasks[n - 1]->next = NULL;
+                free_task_list(tasks[0]);
+            } else {
+                for (long i = 0; i < n; i++) legacy_free(legacy[i]);
+            }
+            printf("%-8s %5d %10ld %16.1f %16.1f\n", pool ? "pool" : "malloc", r + 1, n,
+                   elapsed * 1e9 / n, (double)used / n);
+        }
+    }
+    free(tasks);
+    free(legacy);
+    free(paths);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,173 @@
+// src/batch.c
+#include "batch.h"
+#include "task.h"
+#include "log.h"
+#include "event_loop.h" // monotonic_ns
+#include "zstd_engine.h" // ZSTD_SEEKABLE_MAX_FRAME_MB
+
+#include <math.h>      // isfinite
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BATCH_MAX_FIELDS 5
+
+static int parse_int(const char *s, int *out) {
+    char *end;
+    long v = strtol(s, &end, 10);
+    if (end == s || *end != '\0' || v < -1000000 || v > 1000000) return -1;
+    *out = (int)v;
+    return 0;
+}
+
+// "3600" : secondes après la soumission ; "06:30" : prochain passage de
+// l'horloge locale à cette heure. Résultat en monotonic_ns.
+static int parse_deadline(const char *s, long long *deadline_ns) {
+    long long now = monotonic_ns();
+    if (strchr(s, ':')) {
+        int h, m;
+        char extra;
+        if (sscanf(s, "%d:%d%c", &h, &m, &extra) != 2 || h < 0 || h > 23 || m < 0 || m > 59) return -1;
+        time_t t = time(NULL);
+        struct tm tm;
+        localtime_r(&t, &tm);
+        tm.tm_hour = h;
+        tm.tm_min = m;
+        tm.tm_sec = 0;
+        tm.tm_isdst = -1;
+        time_t target = mktime(&tm);
+        if (target <= t) {
+            tm.tm_mday++; // déjà passée aujourd'hui : demain
+            tm.tm_isdst = -1;
+            target = mktime(&tm);
+        }
+        if (target == (time_t)-1) return -1;
+        *deadline_ns = now + (long long)(target - t) * 1000000000LL;
+        return 0;
+    }
+    char *end;
+    double v = strtod(s, &end);
+    if (end == s || *end != '\0' || !isfinite(v) || v <= 0 || v > 366 * 86400.0) return -1;
+    *deadline_ns = now + (long long)(v * 1e9);
+    return 0;
+}
+
+// "level=9,threads=0" : applique les options reconnues à la tâche
+static const char *apply_options(Task *t, char *opts) {
+    char *save;
+    for (char *opt = strtok_r(opts, ",", &save); opt; opt = strtok_r(NULL, ",", &save)) {
+        char *eq = strchr(opt, '=');
+        int v;
+        if (strncmp(opt, "deadline=", 9) == 0) {
+            if (parse_deadline(eq + 1, &t->deadline_ns) == -1) return "échéance invalide";
+            continue;
+        }
+        if (!eq || parse_int(eq + 1, &v) == -1) return "option invalide";
+        *eq = '\0';
+        if (strcmp(opt, "level") == 0 && v >= 1 && v <= 19) {
+            t->zopt.level = v;
+        } else if (strcmp(opt, "threads") == 0 && v >= 0) {
+            t->zopt.threads = v;
+        } else if (strcmp(opt, "frames") == 0 && v >= 0 && v <= ZSTD_SEEKABLE_MAX_FRAME_MB) {
+            t->zopt.frame_mb = v;
+        } else if (strcmp(opt, "segments") == 0 && t->type == TASK_CONV_VIDEO && v >= 0 && v <= 64) {
+            t->seg.stage = v > 1 ? SEG_SPLIT : SEG_NONE;
+            t->seg.count = v;
+        } else {
+            return "option inconnue ou hors limites";
+        }
+    }
+    return NULL;
+}
+
+Task *batch_parse_line(char *line, const char **err) {
+    char *field[BATCH_MAX_FIELDS] = { NULL };
+    int n = 0;
+    for (char *p = line; p && n < BATCH_MAX_FIELDS; n++) {
+        field[n] = p;
+        p = strchr(p, '\t');
+        if (p) *p++ = '\0';
+    }
+    for (int i = 2; i < n; i++) {
+        if (strcmp(field[i], "-") == 0 || field[i][0] == '\0') field[i] = NULL;
+    }
+
+    task_type_t type;
+    int prio;
+    if (n < 2 || task_parse_type(field[0], strlen(field[0]), &type) == -1) {
+        *err = "type de tâche inconnu";
+        return NULL;
+    }
+    if (parse_int(field[1], &prio) == -1) {
+        *err = "priorité invalide";
+        return NULL;
+    }
+    const char *p1 = field[2], *p2 = field[3];
+    if ((type != TASK_UPDATE && !p1)
+        || ((type == TASK_CONV_VIDEO || type == TASK_CLONE || type == TASK_WRITE) && !p2)) {
+        *err = "paramètre manquant";
+        return NULL;
+    }
+
+    Task *t = create_task(type, prio, p1, p2);
+    if (!t) {
+        *err = "plus de mémoire";
+        return NULL;
+    }
+    if (field[4] && (*err = apply_options(t, field[4])) != NULL) {
+        free_task(t);
+        return NULL;
+    }
+    return t;
+}
+
+int batch_admit(Queue *q, Task *t, char *msg, size_t len) {
+    long long end = queue_projected_end(q, t);
+    int late = end > t->deadline_ns && t->deadline_ns != 0;
+    if (late) {
+        long long now = monotonic_ns();
+        snprintf(msg, len, "tâche %lu : échéance manquée de %.1f s (fin prévue dans %.1f s, "
+                 "échéance dans %.1f s)", t->id, (end - t->deadline_ns) / 1e9,
+                 (end - now) / 1e9, (t->deadline_ns - now) / 1e9);
+        log_msg("[Admission] %s", msg);
+    }
+    // t peut être lancée et libérée dès qu'elle est dans la file : plus d'accès ensuite
+    enqueue(q, t);
+    return late;
+}
+
+long batch_submit(FILE *in, const char *name, Queue *q, long *errors,
+                  const volatile sig_atomic_t *stop) {
+    char *line = NULL;
+    size_t cap = 0;
+    ssize_t len;
+    long lineno = 0, submitted = 0;
+    *errors = 0;
+
+    while (!(stop && *stop) && (len = getline(&line, &cap, in)) != -1) {
+        lineno++;
+        while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) line[--len] = '\0';
+        if (len == 0 || line[0] == '#') continue;
+
+        const char *err = NULL;
+        Task *t = batch_parse_line(line, &err);
+        if (!t) {
+            fprintf(stderr, "[Batch] %s:%ld: %s\n", name, lineno, err);
+            (*errors)++;
+            continue;
+        }
+        // Dans la file tout de suite : l'ordonnanceur tourne déjà
+        char warn[160];
+        if (batch_admit(q, t, warn, sizeof(warn)) == 1) {
+            fprintf(stderr, "[Batch] %s:%ld: %s\n", name, lineno, warn);
+        }
+        submitted++;
+    }
+    if (ferror(in)) {
+        perror("[Batch] lecture du manifeste");
+        (*errors)++;
+    }
+    free(line);
+    return submitted;
+}
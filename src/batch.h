@@ -0,0 +1,37 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdio.h>
+#include <signal.h>   // sig_atomic_t
+#include "queue.h"
+#include "task.h"
+
+//Manifeste de soumission non interactive, une tâche par ligne, champs
+//séparés par des tabulations :
+//  type  priorité  [param1  [param2  [options]]]
+//type : convert | compress | update | clone (ou 0..3) ; "-" = paramètre absent
+//  synthétiques (4..7) : spin MS | sleep MS | write KIO FICHIER | memory MIO
+//options : "clé=valeur" séparées par des virgules
+//  level, threads, frames (Mio, format seekable, <= ZSTD_SEEKABLE_MAX_FRAME_MB),
+//  segments (convert seulement, 0..64)
+//  deadline : échéance, en secondes après la soumission (3600) ou heure
+//  locale (06:30, le lendemain si elle est passée) ; ordonnée par --algo edf
+//Les lignes vides et celles commençant par '#' sont ignorées.
+
+//Une ligne (modifiée sur place) -> une tâche ; NULL et *err renseigné si invalide
+Task *batch_parse_line(char *line, const char **err);
+
+//Met t dans la file. En ordre EDF, si la fin projetée d'après les durées
+//estimées dépasse son échéance, décrit le retard dans msg (journalisé aussi)
+//et retourne 1 : la tâche est admise quand même, au soumetteur de décider.
+//Retourne 0 sinon.
+int batch_admit(Queue *q, Task *t, char *msg, size_t len);
+
+//Lit le manifeste au fil de l'eau et met chaque tâche dans la file dès sa
+//ligne lue ; les lignes invalides sont signalées sur stderr (name:ligne) et
+//comptées dans *errors. S'arrête avant la ligne suivante dès que *stop est
+//non nul (stop peut être NULL). Retourne le nombre de tâches soumises.
+long batch_submit(FILE *in, const char *name, Queue *q, long *errors,
+                  const volatile sig_atomic_t *stop);
+
+#endif // BATCH_H
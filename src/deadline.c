@@ -0,0 +1,183 @@
+// src/deadline.c
+#include "deadline.h"
+
+#include <stdlib.h>
+
+#define DEADLINE_SLAB 256 // nœuds par bloc alloué
+
+struct DeadlineNode {
+    long long deadline_ns;
+    unsigned long id;        // départage les échéances égales
+    long long est_ns;
+    long long sum_ns;        // est_ns du sous-arbre, ce nœud compris
+    unsigned int prio;       // tas sur prio : profondeur O(log n) en moyenne
+    DeadlineNode *left, *right;
+};
+
+struct DeadlineSlab {
+    DeadlineSlab *next;
+    DeadlineNode nodes[DEADLINE_SLAB];
+};
+
+void deadline_index_init(DeadlineIndex *ix) {
+    ix->root = NULL;
+    ix->free_list = NULL;
+    ix->slabs = NULL;
+    ix->seed = 2463534242u;
+    ix->count = 0;
+    pthread_mutex_init(&ix->lock, NULL);
+}
+
+void deadline_index_destroy(DeadlineIndex *ix) {
+    while (ix->slabs) {
+        DeadlineSlab *s = ix->slabs;
+        ix->slabs = s->next;
+        free(s);
+    }
+    ix->root = NULL;
+    ix->free_list = NULL;
+    ix->count = 0;
+    pthread_mutex_destroy(&ix->lock);
+}
+
+// ====== Arbre (verrou tenu) ======
+static long long sum_of(const DeadlineNode *n) {
+    return n ? n->sum_ns : 0;
+}
+
+static void update(DeadlineNode *n) {
+    n->sum_ns = sum_of(n->left) + n->est_ns + sum_of(n->right);
+}
+
+static int cmp_key(long long deadline_ns, unsigned long id, const DeadlineNode *n) {
+    if (deadline_ns != n->deadline_ns) return deadline_ns < n->deadline_ns ? -1 : 1;
+    return (id > n->id) - (id < n->id);
+}
+
+// n -> clés < celle de k à gauche, les autres à droite
+static void split(DeadlineNode *n, const DeadlineNode *k, DeadlineNode **l, DeadlineNode **r) {
+    if (!n) {
+        *l = *r = NULL;
+        return;
+    }
+    if (cmp_key(n->deadline_ns, n->id, k) < 0) {
+        split(n->right, k, &n->right, r);
+        *l = n;
+    } else {
+        split(n->left, k, l, &n->left);
+        *r = n;
+    }
+    update(n);
+}
+
+// Toutes les clés de a précèdent celles de b
+static DeadlineNode *merge(DeadlineNode *a, DeadlineNode *b) {
+    if (!a) return b;
+    if (!b) return a;
+    if (a->prio > b->prio) {
+        a->right = merge(a->right, b);
+        update(a);
+        return a;
+    }
+    b->left = merge(a, b->left);
+    update(b);
+    return b;
+}
+
+static DeadlineNode *insert(DeadlineNode *n, DeadlineNode *x) {
+    if (!n) return x;
+    if (x->prio > n->prio) {
+        split(n, x, &x->left, &x->right);
+        update(x);
+        return x;
+    }
+    if (cmp_key(x->deadline_ns, x->id, n) < 0) n->left = insert(n->left, x);
+    else n->right = insert(n->right, x);
+    update(n);
+    return n;
+}
+
+static DeadlineNode *erase(DeadlineNode *n, long long deadline_ns, unsigned long id, DeadlineNode **out) {
+    if (!n) return NULL;
+    int c = cmp_key(deadline_ns, id, n);
+    if (c == 0) {
+        *out = n;
+        return merge(n->left, n->right);
+    }
+    if (c < 0) n->left = erase(n->left, deadline_ns, id, out);
+    else n->right = erase(n->right, deadline_ns, id, out);
+    update(n);
+    return n;
+}
+
+static DeadlineNode *node_alloc(DeadlineIndex *ix) {
+    if (!ix->free_list) {
+        DeadlineSlab *s = malloc(sizeof(DeadlineSlab));
+        if (!s) return NULL;
+        s->next = ix->slabs;
+        ix->slabs = s;
+        for (int i = 0; i < DEADLINE_SLAB; i++) {
+            s->nodes[i].right = ix->free_list;
+            ix->free_list = &s->nodes[i];
+        }
+    }
+    DeadlineNode *n = ix->free_list;
+    ix->free_list = n->right;
+    return n;
+}
+
+// xorshift32 : priorités de l'arbre, sans toucher à rand()
+static unsigned int next_prio(DeadlineIndex *ix) {
+    unsigned int x = ix->seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    ix->seed = x;
+    return x;
+}
+
+// ====== Interface ======
+int deadline_index_insert(DeadlineIndex *ix, const Task *t) {
+    pthread_mutex_lock(&ix->lock);
+    DeadlineNode *n = node_alloc(ix);
+    if (n) {
+        n->deadline_ns = t->deadline_ns;
+        n->id = t->id;
+        n->est_ns = t->est_ns;
+        n->sum_ns = t->est_ns;
+        n->prio = next_prio(ix);
+        n->left = n->right = NULL;
+        ix->root = insert(ix->root, n);
+        ix->count++;
+    }
+    pthread_mutex_unlock(&ix->lock);
+    return n ? 0 : -1;
+}
+
+void deadline_index_remove(DeadlineIndex *ix, const Task *t) {
+    pthread_mutex_lock(&ix->lock);
+    DeadlineNode *n = NULL;
+    ix->root = erase(ix->root, t->deadline_ns, t->id, &n);
+    if (n) {
+        n->right = ix->free_list;
+        ix->free_list = n;
+        ix->count--;
+    }
+    pthread_mutex_unlock(&ix->lock);
+}
+
+long long deadline_index_work_before(DeadlineIndex *ix, long long deadline_ns) {
+    pthread_mutex_lock(&ix->lock);
+    long long sum = 0;
+    // descente unique : à chaque nœud retenu, tout son sous-arbre gauche l'est aussi
+    for (DeadlineNode *n = ix->root; n; ) {
+        if (n->deadline_ns <= deadline_ns) {
+            sum += sum_of(n->left) + n->est_ns;
+            n = n->right;
+        } else {
+            n = n->left;
+        }
+    }
+    pthread_mutex_unlock(&ix->lock);
+    return sum;
+}
@@ -0,0 +1,36 @@
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <pthread.h>
+#include "task.h"
+
+//Index des tâches à échéance en attente, trié par échéance (arbre binaire
+//de recherche équilibré aléatoirement, « treap ») : chaque nœud porte la
+//somme des durées estimées de son sous-arbre, d'où en O(log n) le travail
+//qui passera avant une échéance donnée en EDF (contrôle d'admission).
+
+typedef struct DeadlineNode DeadlineNode;
+typedef struct DeadlineSlab DeadlineSlab;
+
+typedef struct {
+    DeadlineNode *root;
+    DeadlineNode *free_list; //nœuds libérés, réutilisés avant d'en allouer
+    DeadlineSlab *slabs; //blocs de nœuds alloués
+    unsigned int seed; //tirage des priorités de l'arbre
+    int count; //tâches indexées
+    pthread_mutex_t lock; //soumetteurs et ordonnanceur
+} DeadlineIndex;
+
+void deadline_index_init(DeadlineIndex *ix);
+void deadline_index_destroy(DeadlineIndex *ix);
+
+//Indexe t (clé : deadline_ns puis id, valeur : est_ns) ; -1 si plus de mémoire
+int deadline_index_insert(DeadlineIndex *ix, const Task *t);
+
+//Retire t s'il est indexé
+void deadline_index_remove(DeadlineIndex *ix, const Task *t);
+
+//Somme des durées estimées des tâches indexées d'échéance <= deadline_ns
+long long deadline_index_work_before(DeadlineIndex *ix, long long deadline_ns);
+
+#endif // DEADLINE_H
@@ -0,0 +1,152 @@
+// src/estimate.c
+#include "estimate.h"
+#include "log.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>      // isfinite
+#include <pthread.h>
+#include <sys/stat.h>
+
+
+// Avant toute mesure : ~20 Mo/s en conversion, ~100 Mo/s en compression,
+// 1 ms par ms de calcul ou de sommeil, ~500 Mo/s en écriture, ~3 Go/s en mémoire
+static const double prior_rate[TASK_TYPE_COUNT] = { 50.0, 10.0, 0.0, 0.0, 1e6, 1e6, 2000.0, 300000.0 };
+static const double prior_mean_ns[TASK_TYPE_COUNT] = { 60e9, 5e9, 60e9, 20e9, 1e9, 1e9, 1e9, 1e9 };
+
+// Modèle de l'ordonnanceur (estimate_runtime / estimate_record)
+static RuntimeModel model;
+static pthread_mutex_t model_lock = PTHREAD_MUTEX_INITIALIZER;
+static int model_loaded;
+static int model_dirty; // appris depuis le dernier enregistrement
+
+void estimate_model_init(RuntimeModel *m) {
+    memset(m, 0, sizeof(*m));
+    for (int i = 0; i < TASK_TYPE_COUNT; i++) {
+        m->rate[i] = prior_rate[i];
+        m->mean_ns[i] = prior_mean_ns[i];
+    }
+}
+
+long long estimate_model_runtime(const RuntimeModel *m, task_type_t type, long long work) {
+    double ns = work > 0 && m->rate[type] > 0 ? m->rate[type] * (double)work : m->mean_ns[type];
+    // 0 reste réservé à « pas d'estimation »
+    return ns >= 1.0 ? (long long)ns : 1;
+}
+
+// Moyenne mobile ; la première mesure remplace la valeur par défaut
+static void ewma(double *avg, unsigned long *runs, double sample) {
+    *avg = *runs == 0 ? sample : *avg + ESTIMATE_ALPHA * (sample - *avg);
+    (*runs)++;
+}
+
+void estimate_model_learn(RuntimeModel *m, task_type_t type, long long work, long long run_ns) {
+    if (run_ns <= 0) return;
+    if (work > 0) ewma(&m->rate[type], &m->rate_runs[type], (double)run_ns / (double)work);
+    ewma(&m->mean_ns[type], &m->mean_runs[type], (double)run_ns);
+}
+
+int estimate_model_load(RuntimeModel *m, const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    char line[256], name[32];
+    double rate, mean;
+    unsigned long rate_runs, mean_runs;
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#') continue;
+        if (sscanf(line, "%31s %lf %lu %lf %lu", name, &rate, &rate_runs, &mean, &mean_runs) != 5
+            || !isfinite(rate) || !isfinite(mean) || rate < 0 || mean < 0) continue;
+        task_type_t i;
+        if (task_parse_type(name, strlen(name), &i) < 0) continue;
+        m->rate[i] = rate;
+        m->rate_runs[i] = rate_runs;
+        m->mean_ns[i] = mean;
+        m->mean_runs[i] = mean_runs;
+    }
+    fclose(f);
+    return 0;
+}
+
+int estimate_model_save(const RuntimeModel *m, const char *path) {
+    char tmp[4096];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp)) return -1;
+    FILE *f = fopen(tmp, "w");
+    if (!f) return -1;
+    fprintf(f, "# type\tns/unité\texécutions\tmoyenne(ns)\texécutions\n");
+    for (int i = 0; i < TASK_TYPE_COUNT; i++) {
+        fprintf(f, "%s\t%.6g\t%lu\t%.6g\t%lu\n", task_type_names[i], m->rate[i], m->rate_runs[i],
+                m->mean_ns[i], m->mean_runs[i]);
+    }
+    if (fclose(f) != 0 || rename(tmp, path) == -1) {
+        remove(tmp);
+        return -1;
+    }
+    return 0;
+}
+
+// Nombre entier strictement positif en tête de s, 0 sinon
+static long long leading_count(const char *s) {
+    if (!s) return 0;
+    long long v = strtoll(s, NULL, 10);
+    return v > 0 ? v : 0;
+}
+
+long long estimate_work(const Task *t) {
+    // un segment ne fait qu'une partie du fichier, l'assemblage presque rien de mesurable
+    if (t->seg.stage == SEG_PART || t->seg.stage == SEG_CONCAT) return 0;
+    switch (t->type) {
+        case TASK_CONV_VIDEO:
+        case TASK_COMPRESS: {
+            struct stat st;
+            // un dossier (archive tar) n'a pas de taille simple : durée moyenne du type
+            if (!t->param1 || stat(t->param1, &st) == -1 || !S_ISREG(st.st_mode)) return 0;
+            return (long long)st.st_size;
+        }
+        case TASK_SPIN:
+        case TASK_SLEEP:
+        case TASK_WRITE:
+        case TASK_MEMORY:
+            return leading_count(t->param1);
+        default:
+            return 0;
+    }
+}
+
+// Mutex tenu
+static void ensure_loaded(void) {
+    if (model_loaded) return;
+    model_loaded = 1;
+    estimate_model_init(&model);
+    if (estimate_model_load(&model, ESTIMATE_STATE_PATH) == -1 && errno != ENOENT) {
+        log_msg("[Scheduler][ERREUR] historique des durées %s: %s", ESTIMATE_STATE_PATH, strerror(errno));
+    }
+}
+
+long long estimate_runtime(task_type_t type, long long work) {
+    pthread_mutex_lock(&model_lock);
+    ensure_loaded();
+    long long ns = estimate_model_runtime(&model, type, work);
+    pthread_mutex_unlock(&model_lock);
+    return ns;
+}
+
+void estimate_record(const Task *t, long long run_ns) {
+    pthread_mutex_lock(&model_lock);
+    ensure_loaded();
+    estimate_model_learn(&model, t->type, t->work, run_ns);
+    model_dirty = 1;
+    pthread_mutex_unlock(&model_lock);
+}
+
+int estimate_save(void) {
+    pthread_mutex_lock(&model_lock);
+    int res = 0;
+    if (model_dirty) {
+        res = estimate_model_save(&model, ESTIMATE_STATE_PATH) == -1 ? -1 : 1;
+        if (res == 1) model_dirty = 0;
+    }
+    pthread_mutex_unlock(&model_lock);
+    return res;
+}
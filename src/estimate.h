@@ -0,0 +1,49 @@
+#ifndef ESTIMATE_H
+#define ESTIMATE_H
+
+#include "task.h"
+
+//Estimation de la durée d'exécution d'une tâche avant son lancement (SJF).
+//Chaque type apprend, par moyenne mobile exponentielle sur ses exécutions
+//réussies, une durée par unité de travail (octets du fichier d'entrée pour
+//conversion et compression, ms pour calcul et sommeil, Kio pour écriture,
+//Mio pour mémoire) et une durée moyenne pour les tâches de taille inconnue
+//(mises à jour, clonages, dossiers). L'historique survit aux redémarrages.
+
+#define ESTIMATE_STATE_PATH "/var/tmp/scheduler-runtimes.tsv"
+#define ESTIMATE_ALPHA 0.2 //poids de la dernière exécution dans la moyenne
+
+typedef struct {
+    double rate[TASK_TYPE_COUNT]; //ns par unité de travail
+    double mean_ns[TASK_TYPE_COUNT]; //durée d'une tâche de taille inconnue
+    unsigned long rate_runs[TASK_TYPE_COUNT]; //exécutions apprises (0 : valeur par défaut)
+    unsigned long mean_runs[TASK_TYPE_COUNT];
+} RuntimeModel;
+
+//Modèle initial : ordres de grandeur par type, remplacés dès la première mesure
+void estimate_model_init(RuntimeModel *m);
+
+//Durée estimée en ns d'une tâche type de work unités (0 : taille inconnue)
+long long estimate_model_runtime(const RuntimeModel *m, task_type_t type, long long work);
+
+//Intègre une exécution mesurée de run_ns
+void estimate_model_learn(RuntimeModel *m, task_type_t type, long long work, long long run_ns);
+
+//Lecture / écriture (atomique) du modèle ; -1 et errno en cas d'échec
+int estimate_model_load(RuntimeModel *m, const char *path);
+int estimate_model_save(const RuntimeModel *m, const char *path);
+
+//Unités de travail de t d'après ses paramètres (stat de param1 pour les
+//fichiers) ; 0 si la taille est inconnue
+long long estimate_work(const Task *t);
+
+//Modèle de l'ordonnanceur, chargé depuis ESTIMATE_STATE_PATH au premier usage
+//(utilisable depuis n'importe quel thread)
+long long estimate_runtime(task_type_t type, long long work);
+void estimate_record(const Task *t, long long run_ns);
+
+//Enregistre le modèle dans ESTIMATE_STATE_PATH s'il a appris depuis le
+//dernier enregistrement ; 1 si écrit, 0 si rien à faire, -1 en cas d'échec
+int estimate_save(void);
+
+#endif // ESTIMATE_H
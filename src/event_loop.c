@@ -0,0 +1,99 @@
+// src/event_loop.c
+#define _GNU_SOURCE
+#include "event_loop.h"
+
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h> // SYS_pidfd_open
+#include <unistd.h>
+#include <errno.h>
+#include <stdint.h>
+#include <time.h>
+
+#define MAX_EVENTS 64
+
+int event_loop_init(EventLoop *el) {
+    el->epfd = epoll_create1(EPOLL_CLOEXEC);
+    return el->epfd == -1 ? -1 : 0;
+}
+
+void event_loop_close(EventLoop *el) {
+    if (el->epfd >= 0) close(el->epfd);
+    el->epfd = -1;
+}
+
+int event_loop_add(EventLoop *el, EventHandler *h, uint32_t events) {
+    struct epoll_event ev;
+    ev.events = events;
+    ev.data.ptr = h;
+    return epoll_ctl(el->epfd, EPOLL_CTL_ADD, h->fd, &ev);
+}
+
+int event_loop_del(EventLoop *el, EventHandler *h) {
+    return epoll_ctl(el->epfd, EPOLL_CTL_DEL, h->fd, NULL);
+}
+
+int event_loop_mod(EventLoop *el, EventHandler *h, uint32_t events) {
+    struct epoll_event ev;
+    ev.events = events;
+    ev.data.ptr = h;
+    return epoll_ctl(el->epfd, EPOLL_CTL_MOD, h->fd, &ev);
+}
+
+int event_loop_wait(EventLoop *el, int timeout_ms) {
+    struct epoll_event events[MAX_EVENTS];
+    int n = epoll_wait(el->epfd, events, MAX_EVENTS, timeout_ms);
+    if (n == -1) {
+        return errno == EINTR ? 0 : -1;
+    }
+    for (int i = 0; i < n; i++) {
+        EventHandler *h = events[i].data.ptr;
+        h->cb(h->arg, events[i].events);
+    }
+    return n;
+}
+
+int pidfd_open_compat(pid_t pid) {
+#ifdef SYS_pidfd_open
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+#else
+    (void)pid;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+int timer_fd_create(void) {
+    return timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+}
+
+int timer_fd_arm(int fd, long ms) {
+    struct itimerspec its = { { 0, 0 }, { 0, 0 } };
+    its.it_value.tv_sec = ms / 1000;
+    its.it_value.tv_nsec = (ms % 1000) * 1000000L;
+    return timerfd_settime(fd, 0, &its, NULL);
+}
+
+long long monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+int wake_fd_create(void) {
+    return eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+void wake_fd_signal(int fd) {
+    uint64_t one = 1;
+    // EAGAIN : compteur saturé, le réveil est déjà en attente
+    while (write(fd, &one, sizeof(one)) == -1 && errno == EINTR) {
+    }
+}
+
+void wake_fd_drain(int fd) {
+    uint64_t count;
+    while (read(fd, &count, sizeof(count)) == -1 && errno == EINTR) {
+    }
+}
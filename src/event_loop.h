@@ -0,0 +1,50 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <stdint.h>
+#include <sys/types.h> // pour pid_t
+
+//Callback appelé quand le fd surveillé est prêt (events = masque EPOLL*)
+typedef void (*event_cb)(void *arg, uint32_t events);
+
+//Descripteur surveillé : appartient à l'appelant et doit vivre tant qu'il est enregistré
+typedef struct EventHandler {
+    int fd;
+    event_cb cb;
+    void *arg;
+} EventHandler;
+
+//Boucle d'événements (epoll) du thread ordonnanceur
+typedef struct EventLoop {
+    int epfd;
+} EventLoop;
+
+//Créer / détruire la boucle
+int event_loop_init(EventLoop *el);
+void event_loop_close(EventLoop *el);
+
+//Enregistrer / retirer un descripteur
+int event_loop_add(EventLoop *el, EventHandler *h, uint32_t events);
+int event_loop_del(EventLoop *el, EventHandler *h);
+int event_loop_mod(EventLoop *el, EventHandler *h, uint32_t events);
+
+//Attendre (timeout_ms < 0 : indéfiniment) et appeler les callbacks prêts.
+//Retourne le nombre d'événements traités, -1 en cas d'erreur.
+int event_loop_wait(EventLoop *el, int timeout_ms);
+
+//pidfd du processus pid (lisible à sa fin), -1 si le noyau ne le supporte pas
+int pidfd_open_compat(pid_t pid);
+
+//timerfd monotone non bloquant ; timer_fd_arm(fd, 0) le désarme
+int timer_fd_create(void);
+int timer_fd_arm(int fd, long ms);
+
+//Horloge monotone des horodatages de l'ordonnanceur, en nanosecondes (vDSO : pas d'appel système)
+long long monotonic_ns(void);
+
+//eventfd non bloquant pour réveiller la boucle depuis un autre thread
+int wake_fd_create(void);
+void wake_fd_signal(int fd);
+void wake_fd_drain(int fd);
+
+#endif // EVENT_LOOP_H
@@ -0,0 +1,121 @@
+// src/fair.c
+#include "fair.h"
+
+#include <stddef.h>     // offsetof
+#include <stdlib.h>
+#include <string.h>
+
+
+// Ordre d'arrivée dans la classe
+static int cmp_seq(const Task *a, const Task *b) {
+    return (a->seq > b->seq) - (a->seq < b->seq);
+}
+
+void fair_init(FairShare *fs) {
+    for (int i = 0; i < TASK_TYPE_COUNT; i++) {
+        heap_init_at(&fs->ready[i], cmp_seq, offsetof(Task, class_idx));
+        fs->weight[i] = FAIR_DEFAULT_WEIGHT;
+        fs->vruntime[i] = 0;
+    }
+    fs->min_vruntime = 0;
+    fs->slice_ns = 0;
+}
+
+void fair_destroy(FairShare *fs) {
+    fair_clear(fs);
+}
+
+int fair_parse_weights(const char *spec, unsigned weight[TASK_TYPE_COUNT]) {
+    for (int i = 0; i < TASK_TYPE_COUNT; i++) weight[i] = FAIR_DEFAULT_WEIGHT;
+    if (!spec) return 0;
+    const char *p = spec;
+    while (*p) {
+        const char *eq = strchr(p, '=');
+        if (!eq) return -1;
+        task_type_t type;
+        int bad = task_parse_type(p, (size_t)(eq - p), &type);
+        char *end;
+        long w = strtol(eq + 1, &end, 10);
+        if (bad || end == eq + 1 || (*end != ',' && *end != '\0')
+            || w < 1 || w > FAIR_MAX_WEIGHT) {
+            return -1;
+        }
+        weight[type] = (unsigned)w;
+        p = *end == ',' ? end + 1 : end;
+    }
+    return 0;
+}
+
+void fair_configure(FairShare *fs, const unsigned *weight, long long slice_ns) {
+    for (int i = 0; i < TASK_TYPE_COUNT; i++) {
+        fs->weight[i] = weight && weight[i] > 0 ? weight[i] : FAIR_DEFAULT_WEIGHT;
+    }
+    fs->slice_ns = slice_ns > 0 ? slice_ns : 0;
+}
+
+int fair_push(FairShare *fs, Task *t) {
+    TaskHeap *h = &fs->ready[t->type];
+    // classe restée vide : elle ne rattrape pas le temps passé sans rien demander
+    if (h->size == 0 && fs->vruntime[t->type] < fs->min_vruntime) {
+        fs->vruntime[t->type] = fs->min_vruntime;
+    }
+    return heap_push(h, t);
+}
+
+void fair_remove(FairShare *fs, Task *t) {
+    heap_remove(&fs->ready[t->type], t);
+}
+
+void fair_clear(FairShare *fs) {
+    for (int i = 0; i < TASK_TYPE_COUNT; i++) {
+        TaskHeap *h = &fs->ready[i];
+        for (int k = 0; k < h->size; k++) h->items[k]->class_idx = -1;
+        heap_destroy(h);
+    }
+}
+
+Task *fair_peek(const FairShare *fs) {
+    Task *best = NULL;
+    long long best_vr = 0;
+    for (int i = 0; i < TASK_TYPE_COUNT; i++) {
+        Task *t = heap_peek(&fs->ready[i]);
+        if (!t) continue;
+        // à temps virtuel égal, la plus ancienne des têtes de classe
+        if (!best || fs->vruntime[i] < best_vr
+            || (fs->vruntime[i] == best_vr && t->seq < best->seq)) {
+            best = t;
+            best_vr = fs->vruntime[i];
+        }
+    }
+    return best;
+}
+
+int fair_should_preempt(const FairShare *fs, task_type_t running, long long cpu_ns) {
+    const Task *next = fair_peek(fs);
+    if (!next) return 0;
+    if (cpu_ns < 0) cpu_ns = 0;
+    // comparé à la mesure du passage, pas à son avance
+    long long vr = fs->vruntime[running] + (cpu_ns - fs->slice_ns) / (long long)fs->weight[running];
+    return next->type == running || fs->vruntime[next->type] < vr;
+}
+
+void fair_take(FairShare *fs, Task *t) {
+    fair_remove(fs, t);
+    if (fs->vruntime[t->type] > fs->min_vruntime) fs->min_vruntime = fs->vruntime[t->type];
+    fs->vruntime[t->type] += fs->slice_ns / fs->weight[t->type];
+}
+
+void fair_account(FairShare *fs, task_type_t type, long long cpu_ns, int again) {
+    if (cpu_ns < 0) cpu_ns = 0;
+    // l'avance du passage terminé est remplacée par la mesure
+    long long delta = cpu_ns - (again ? 0 : fs->slice_ns);
+    fs->vruntime[type] += delta / (long long)fs->weight[type];
+}
+
+void fair_fprint(const FairShare *fs, FILE *f) {
+    for (int i = 0; i < TASK_TYPE_COUNT; i++) {
+        if (fs->vruntime[i] == 0 && fs->ready[i].size == 0) continue;
+        fprintf(f, "  %-9s poids %-4u temps virtuel %10.3f s, %d en attente\n", task_type_names[i],
+                fs->weight[i], fs->vruntime[i] / 1e9, fs->ready[i].size);
+    }
+}
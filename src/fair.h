@@ -0,0 +1,71 @@
+#ifndef FAIR_H
+#define FAIR_H
+
+#include "task.h"
+#include "heap.h"
+
+//Partage proportionnel du CPU entre classes de tâches (une classe par type),
+//à la manière de CFS : chaque classe a un poids et un temps virtuel, le
+//temps CPU réellement consommé par ses tâches divisé par son poids. Le
+//prochain lancement revient toujours à la classe en attente de plus petit
+//temps virtuel, la plus ancienne de ses tâches d'abord : une classe de poids
+//4 reçoit quatre fois le CPU d'une classe de poids 1 tant que les deux
+//attendent, et un afflux de conversions ne prive plus les compressions.
+//Chaque lancement prélève d'avance un passage (slice_ns) sur sa classe, pour
+//que plusieurs workers remplis d'un coup se répartissent entre les classes ;
+//la fin du passage remplace l'avance par le temps CPU mesuré (fair_account).
+
+#define FAIR_DEFAULT_WEIGHT 1
+#define FAIR_MAX_WEIGHT 1000
+
+typedef struct {
+    TaskHeap ready[TASK_TYPE_COUNT]; //tâches en attente de chaque classe, par arrivée (class_idx)
+    unsigned weight[TASK_TYPE_COUNT]; //1..FAIR_MAX_WEIGHT
+    long long vruntime[TASK_TYPE_COUNT]; //ns de CPU divisés par le poids
+    long long min_vruntime; //temps virtuel de la dernière classe servie (croissant)
+    long long slice_ns; //avance prélevée à chaque lancement
+} FairShare;
+
+//Classes vides, poids FAIR_DEFAULT_WEIGHT, temps virtuels à 0
+void fair_init(FairShare *fs);
+void fair_destroy(FairShare *fs);
+
+//"convert=1,compress=4" -> weight[] (classes absentes : FAIR_DEFAULT_WEIGHT) ;
+//types comme dans un manifeste (nom ou numéro). -1 si la liste est invalide.
+int fair_parse_weights(const char *spec, unsigned weight[TASK_TYPE_COUNT]);
+
+//Poids des classes (NULL : poids égaux) et avance par lancement
+void fair_configure(FairShare *fs, const unsigned *weight, long long slice_ns);
+
+//Ajoute t à sa classe ; une classe qui sort de l'inactivité repart au moins
+//de min_vruntime (pas de crédit accumulé en dormant). -1 si plus de mémoire.
+int fair_push(FairShare *fs, Task *t);
+
+//Retire t de sa classe s'il y est
+void fair_remove(FairShare *fs, Task *t);
+
+//Vide toutes les classes (les temps virtuels restent)
+void fair_clear(FairShare *fs);
+
+//Prochaine tâche : la plus ancienne de la classe de plus petit temps virtuel
+//(NULL si tout est vide)
+Task *fair_peek(const FairShare *fs);
+
+//Passage d'une tâche de la classe running écoulé après cpu_ns de CPU (pas
+//encore soldé) : 1 si la prochaine tâche (fair_peek) doit prendre sa place,
+//c'est-à-dire si sa classe a un temps virtuel plus petit que celui de running
+//une fois le passage soldé, ou si c'est une autre tâche de la même classe
+//(tourniquet dans la classe) ; 0 si running reste la moins servie
+int fair_should_preempt(const FairShare *fs, task_type_t running, long long cpu_ns);
+
+//t part sur un worker : retirée de sa classe, qui paie un passage d'avance
+void fair_take(FairShare *fs, Task *t);
+
+//Fin d'un passage de la classe type, qui a consommé cpu_ns ; again : la
+//tâche repart aussitôt pour un passage (nouvelle avance)
+void fair_account(FairShare *fs, task_type_t type, long long cpu_ns, int again);
+
+//Une ligne par classe active (poids, temps virtuel, tâches en attente)
+void fair_fprint(const FairShare *fs, FILE *f);
+
+#endif // FAIR_H
@@ -0,0 +1,110 @@
+// src/heap.c
+#include "heap.h"
+#include <stdlib.h>
+
+#define HEAP_INITIAL_CAP 64
+
+static int *idx_of(const TaskHeap *h, Task *t) {
+    return (int *)((char *)t + h->idx_off);
+}
+
+static void heap_place(TaskHeap *h, int i, Task *t) {
+    h->items[i] = t;
+    *idx_of(h, t) = i;
+}
+
+static void sift_up(TaskHeap *h, int i) {
+    Task *t = h->items[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (h->cmp(t, h->items[parent]) >= 0) break;
+        heap_place(h, i, h->items[parent]);
+        i = parent;
+    }
+    heap_place(h, i, t);
+}
+
+static void sift_down(TaskHeap *h, int i) {
+    Task *t = h->items[i];
+    while (1) {
+        int child = 2 * i + 1;
+        if (child >= h->size) break;
+        if (child + 1 < h->size && h->cmp(h->items[child + 1], h->items[child]) < 0) {
+            child++;
+        }
+        if (h->cmp(h->items[child], t) >= 0) break;
+        heap_place(h, i, h->items[child]);
+        i = child;
+    }
+    heap_place(h, i, t);
+}
+
+void heap_init(TaskHeap *h, task_cmp_fn cmp) {
+    heap_init_at(h, cmp, offsetof(Task, heap_idx));
+}
+
+void heap_init_at(TaskHeap *h, task_cmp_fn cmp, size_t idx_off) {
+    h->items = NULL;
+    h->size = 0;
+    h->cap = 0;
+    h->cmp = cmp;
+    h->idx_off = idx_off;
+}
+
+void heap_destroy(TaskHeap *h) {
+    free(h->items);
+    h->items = NULL;
+    h->size = 0;
+    h->cap = 0;
+}
+
+int heap_push(TaskHeap *h, Task *t) {
+    if (h->size == h->cap) {
+        int cap = h->cap ? h->cap * 2 : HEAP_INITIAL_CAP;
+        Task **items = realloc(h->items, (size_t)cap * sizeof(Task *));
+        if (!items) return -1;
+        h->items = items;
+        h->cap = cap;
+    }
+    h->items[h->size] = t;
+    sift_up(h, h->size++);
+    return 0;
+}
+
+Task *heap_peek(const TaskHeap *h) {
+    return h->size > 0 ? h->items[0] : NULL;
+}
+
+Task *heap_pop(TaskHeap *h) {
+    if (h->size == 0) return NULL;
+    Task *top = h->items[0];
+    heap_remove(h, top);
+    return top;
+}
+
+void heap_remove(TaskHeap *h, Task *t) {
+    int i = *idx_of(h, t);
+    if (i < 0 || i >= h->size || h->items[i] != t) return;
+    Task *last = h->items[--h->size];
+    *idx_of(h, t) = -1;
+    if (last == t) return;
+    heap_place(h, i, last);
+    heap_update(h, last);
+}
+
+void heap_update(TaskHeap *h, Task *t) {
+    int i = *idx_of(h, t);
+    if (i < 0 || i >= h->size) return;
+    if (i > 0 && h->cmp(t, h->items[(i - 1) / 2]) < 0) {
+        sift_up(h, i);
+    } else {
+        sift_down(h, i);
+    }
+}
+
+void heap_set_cmp(TaskHeap *h, task_cmp_fn cmp) {
+    h->cmp = cmp;
+    for (int i = h->size / 2 - 1; i >= 0; i--) {
+        sift_down(h, i);
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#include <stddef.h> // size_t
+#include "task.h"
+
+//Comparateur : < 0 si a doit sortir avant b
+typedef int (*task_cmp_fn)(const Task *a, const Task *b);
+
+//Tas binaire de tâches (min selon cmp) ; chaque tâche mémorise sa position
+//dans heap_idx pour permettre retrait et mise à jour en O(log n)
+typedef struct TaskHeap {
+    Task **items;
+    int size;
+    int cap;
+    task_cmp_fn cmp;
+    size_t idx_off; //position de l'int de Task qui reçoit l'indice (heap_idx par défaut)
+} TaskHeap;
+
+void heap_init(TaskHeap *h, task_cmp_fn cmp);
+
+//Tas secondaire sur les mêmes tâches : indice rangé dans un autre int de Task
+//(offsetof(Task, wait_idx)), pour qu'une tâche soit dans deux tas à la fois
+void heap_init_at(TaskHeap *h, task_cmp_fn cmp, size_t idx_off);
+void heap_destroy(TaskHeap *h);
+
+//Insérer (0 si ok, -1 si plus de mémoire)
+int heap_push(TaskHeap *h, Task *t);
+
+//Retirer / consulter le minimum (NULL si vide)
+Task *heap_pop(TaskHeap *h);
+Task *heap_peek(const TaskHeap *h);
+
+//Retirer une tâche quelconque du tas
+void heap_remove(TaskHeap *h, Task *t);
+
+//Replacer une tâche dont la clé a changé
+void heap_update(TaskHeap *h, Task *t);
+
+//Changer d'ordre : réorganise tout le tas en O(n)
+void heap_set_cmp(TaskHeap *h, task_cmp_fn cmp);
+
+#endif // HEAP_H
@@ -0,0 +1,153 @@
+// src/latency.c
+#include "latency.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HALF (1 << (LAT_SUB_BITS - 1))
+
+static const char *algo_names[ALG_COUNT] = { "fifo", "rr", "priority", "mlfq", "sjf", "edf", "fair" };
+static const char *metric_names[LAT_METRICS] = { "waiting", "response", "turnaround", "dispatch" };
+
+typedef struct {
+    unsigned long long tasks;
+    unsigned long long preemptions;
+    Histogram *h[LAT_METRICS]; // alloués au premier enregistrement
+} LatencyGroup;
+
+static LatencyGroup groups[ALG_COUNT][TASK_TYPE_COUNT];
+static volatile sig_atomic_t dump_requested;
+
+// ====== Histogramme ======
+static int bucket_index(unsigned long long v) {
+    if (v >> LAT_MAX_BITS) v = (1ULL << LAT_MAX_BITS) - 1;
+    if (v < (1u << LAT_SUB_BITS)) return (int)v;
+    int top = 63 - __builtin_clzll(v);
+    int shift = top - LAT_SUB_BITS + 1;
+    return shift * HALF + (int)(v >> shift);
+}
+
+// Plus grande valeur rangée dans l'intervalle idx
+static unsigned long long bucket_upper(int idx) {
+    if (idx < (1 << LAT_SUB_BITS)) return (unsigned long long)idx;
+    int shift = idx / HALF - 1;
+    unsigned long long sub = (unsigned long long)(idx - shift * HALF);
+    return ((sub + 1) << shift) - 1;
+}
+
+void hist_record(Histogram *h, unsigned long long us) {
+    h->counts[bucket_index(us)]++;
+    if (h->count == 0 || us < h->min) h->min = us;
+    if (us > h->max) h->max = us;
+    h->count++;
+    h->sum += us;
+}
+
+unsigned long long hist_percentile(const Histogram *h, double p) {
+    if (h->count == 0) return 0;
+    unsigned long long target = (unsigned long long)(p / 100.0 * (double)h->count + 0.999999);
+    if (target == 0) target = 1;
+    unsigned long long seen = 0;
+    for (int i = 0; i < LAT_BUCKETS; i++) {
+        seen += h->counts[i];
+        if (seen >= target) {
+            unsigned long long v = bucket_upper(i);
+            return v < h->max ? v : h->max;
+        }
+    }
+    return h->max;
+}
+
+// ====== Mesures par algorithme et type ======
+static void record(LatencyGroup *g, lat_metric_t m, long long ns) {
+    if (!g->h[m] && !(g->h[m] = calloc(1, sizeof(Histogram)))) return; // mesure perdue
+    hist_record(g->h[m], ns > 0 ? (unsigned long long)(ns / 1000) : 0);
+}
+
+void latency_record(algo_t alg, const Task *t) {
+    if ((int)alg < 0 || alg >= ALG_COUNT || (int)t->type < 0 || t->type >= TASK_TYPE_COUNT
+        || !t->enqueue_ns) {
+        return;
+    }
+    LatencyGroup *g = &groups[alg][t->type];
+    g->tasks++;
+    g->preemptions += (unsigned long long)t->preemptions;
+    record(g, LAT_WAITING, t->wait_ns);
+    if (t->start_ns) record(g, LAT_RESPONSE, t->start_ns - t->enqueue_ns);
+    if (t->end_ns) record(g, LAT_TURNAROUND, t->end_ns - t->enqueue_ns);
+}
+
+void latency_record_dispatch(algo_t alg, task_type_t type, long long ns) {
+    if ((int)alg < 0 || alg >= ALG_COUNT || (int)type < 0 || type >= TASK_TYPE_COUNT) return;
+    record(&groups[alg][type], LAT_DISPATCH, ns);
+}
+
+const Histogram *latency_histogram(algo_t alg, task_type_t type, lat_metric_t m) {
+    if ((int)alg < 0 || alg >= ALG_COUNT || (int)type < 0 || type >= TASK_TYPE_COUNT
+        || (int)m < 0 || m >= LAT_METRICS) {
+        return NULL;
+    }
+    return groups[alg][type].h[m];
+}
+
+static void write_hist(FILE *f, const Histogram *h) {
+    fprintf(f, "{\"count\":%llu,\"min\":%llu,\"max\":%llu,\"mean\":%.1f,"
+               "\"p50\":%llu,\"p90\":%llu,\"p99\":%llu,\"p999\":%llu,\"buckets\":[",
+            h->count, h->min, h->max, (double)h->sum / (double)h->count,
+            hist_percentile(h, 50), hist_percentile(h, 90), hist_percentile(h, 99),
+            hist_percentile(h, 99.9));
+    // [borne haute, effectif] des intervalles non vides
+    int first = 1;
+    for (int i = 0; i < LAT_BUCKETS; i++) {
+        if (!h->counts[i]) continue;
+        fprintf(f, "%s[%llu,%llu]", first ? "" : ",", bucket_upper(i), h->counts[i]);
+        first = 0;
+    }
+    fprintf(f, "]}");
+}
+
+void latency_write_json(FILE *f) {
+    fprintf(f, "{\"unit\":\"us\",\"sub_bucket_bits\":%d,\"groups\":[", LAT_SUB_BITS);
+    int first = 1;
+    for (int a = 0; a < ALG_COUNT; a++) {
+        for (int ty = 0; ty < TASK_TYPE_COUNT; ty++) {
+            const LatencyGroup *g = &groups[a][ty];
+            if (g->tasks == 0) continue;
+            fprintf(f, "%s\n{\"algo\":\"%s\",\"type\":\"%s\",\"tasks\":%llu,\"preemptions\":%llu",
+                    first ? "" : ",", algo_names[a], task_type_names[ty], g->tasks, g->preemptions);
+            for (int m = 0; m < LAT_METRICS; m++) {
+                if (!g->h[m] || g->h[m]->count == 0) continue;
+                fprintf(f, ",\"%s\":", metric_names[m]);
+                write_hist(f, g->h[m]);
+            }
+            fprintf(f, "}");
+            first = 0;
+        }
+    }
+    fprintf(f, "\n]}\n");
+}
+
+int latency_dump_file(const char *path) {
+    char tmp[4096];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp)) return -1;
+    FILE *f = fopen(tmp, "w");
+    if (!f) return -1;
+    latency_write_json(f);
+    if (fclose(f) != 0 || rename(tmp, path) == -1) {
+        remove(tmp);
+        return -1;
+    }
+    return 0;
+}
+
+void latency_request_dump(void) {
+    dump_requested = 1;
+}
+
+int latency_take_request(void) {
+    if (!dump_requested) return 0;
+    dump_requested = 0;
+    return 1;
+}
@@ -0,0 +1,61 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdio.h>
+#include "task.h"
+#include "scheduler.h"
+
+//Histogrammes de latence façon HDR : échelle log-linéaire en microsecondes,
+//LAT_SUB_BITS bits significatifs par puissance de 2 (erreur relative < 1/32),
+//de 1 µs à 2^LAT_MAX_BITS µs (~12 jours). Enregistrer coûte quelques opérations
+//sur des entiers ; les histogrammes (un par algorithme, type de tâche et mesure)
+//vivent toute la durée du processus, pour comparer des exécutions successives.
+//Lus et modifiés par le seul thread ordonnanceur.
+#define LAT_SUB_BITS 6
+#define LAT_MAX_BITS 40
+#define LAT_BUCKETS ((LAT_MAX_BITS - LAT_SUB_BITS + 2) << (LAT_SUB_BITS - 1))
+
+#define LATENCY_DUMP_PATH "/tmp/scheduler-latency.json"
+
+typedef enum {
+    LAT_WAITING = 0, //temps cumulé dans la file (arrivée et remises en file)
+    LAT_RESPONSE,    //de l'arrivée au premier lancement
+    LAT_TURNAROUND,  //de l'arrivée à la fin
+    LAT_DISPATCH,    //à chaque lancement ou reprise : de l'instant où la tâche est
+                     //prête et un worker libre jusqu'au fils lancé (ou SIGCONT)
+    LAT_METRICS
+} lat_metric_t;
+
+typedef struct {
+    unsigned long long count;
+    unsigned long long sum; //µs
+    unsigned long long min, max; //µs
+    unsigned long long counts[LAT_BUCKETS];
+} Histogram;
+
+void hist_record(Histogram *h, unsigned long long us);
+
+//Valeur sous laquelle tombent p % des mesures (borne haute de l'intervalle)
+unsigned long long hist_percentile(const Histogram *h, double p);
+
+//Tâche terminée sous l'algorithme alg : ses trois mesures sont enregistrées
+void latency_record(algo_t alg, const Task *t);
+
+//Coût d'un passage de la file à un worker (LAT_DISPATCH), en ns
+void latency_record_dispatch(algo_t alg, task_type_t type, long long ns);
+
+//Histogramme d'une mesure, NULL s'il est encore vide
+const Histogram *latency_histogram(algo_t alg, task_type_t type, lat_metric_t m);
+
+//Tous les histogrammes non vides, en JSON (résumé et intervalles non vides)
+void latency_write_json(FILE *f);
+
+//Écrit le JSON dans path (fichier temporaire puis rename) ; -1 en cas d'erreur
+int latency_dump_file(const char *path);
+
+//Demande d'export depuis un handler de signal ; l'ordonnanceur l'honore à son
+//prochain réveil (latency_take_request retourne 1 une fois par demande)
+void latency_request_dump(void);
+int latency_take_request(void);
+
+#endif // LATENCY_H
@@ -0,0 +1,214 @@
+// src/log.c
+#define _POSIX_C_SOURCE 200809L
+#include "log.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+
+#define LOG_IOBUF_SIZE (64 * 1024)
+
+// Case du tampon circulaire (file bornée multi-producteurs à numéros de séquence) :
+// seq == pos      → libre pour le producteur qui réserve pos
+// seq == pos + 1  → ligne prête pour le consommateur
+typedef struct {
+    unsigned long seq;
+    int len;
+    char text[LOG_LINE_MAX];
+} LogSlot;
+
+static struct {
+    int fd;
+    int flush_ms;
+    unsigned long mask;
+    LogSlot *slots;
+    unsigned long tail;      // prochaine position réservée (producteurs, atomique)
+    unsigned long head;      // prochaine position lue (consommateur, sous drain_mutex)
+    unsigned long dropped;   // lignes perdues (atomique)
+    unsigned long reported;  // pertes déjà signalées dans le fichier
+    int initialized;
+    int stop;
+    pthread_t flusher;
+    pthread_mutex_t drain_mutex; // un seul consommateur à la fois
+    pthread_mutex_t wake_mutex;
+    pthread_cond_t wake;
+    char iobuf[LOG_IOBUF_SIZE];
+} lg = {
+    .fd = -1,
+    .drain_mutex = PTHREAD_MUTEX_INITIALIZER,
+    .wake_mutex = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+};
+
+static pthread_once_t lazy_once = PTHREAD_ONCE_INIT;
+
+static void write_all(const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(lg.fd, buf, len);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+}
+
+// Vide le tampon circulaire dans le fichier, par blocs de LOG_IOBUF_SIZE
+static void drain(void) {
+    pthread_mutex_lock(&lg.drain_mutex);
+    size_t used = 0;
+
+    unsigned long dropped = __atomic_load_n(&lg.dropped, __ATOMIC_RELAXED);
+    if (dropped != lg.reported) {
+        used += (size_t)snprintf(lg.iobuf, LOG_IOBUF_SIZE,
+                                 "[LOG] %lu ligne(s) perdue(s) (tampon plein)\n",
+                                 dropped - lg.reported);
+        lg.reported = dropped;
+    }
+
+    while (1) {
+        LogSlot *slot = &lg.slots[lg.head & lg.mask];
+        unsigned long seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        if (seq != lg.head + 1) break; // rien de prêt
+
+        if (used + (size_t)slot->len + 1 > LOG_IOBUF_SIZE) {
+            write_all(lg.iobuf, used);
+            used = 0;
+        }
+        memcpy(lg.iobuf + used, slot->text, (size_t)slot->len);
+        used += (size_t)slot->len;
+        lg.iobuf[used++] = '\n';
+
+        // Rendre la case aux producteurs pour le tour suivant
+        __atomic_store_n(&slot->seq, lg.head + lg.mask + 1, __ATOMIC_RELEASE);
+        lg.head++;
+    }
+    if (used > 0) write_all(lg.iobuf, used);
+    pthread_mutex_unlock(&lg.drain_mutex);
+}
+
+static void *flusher_main(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&lg.wake_mutex);
+    while (!lg.stop) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += lg.flush_ms / 1000;
+        deadline.tv_nsec += (lg.flush_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&lg.wake, &lg.wake_mutex, &deadline);
+        pthread_mutex_unlock(&lg.wake_mutex);
+        drain();
+        pthread_mutex_lock(&lg.wake_mutex);
+    }
+    pthread_mutex_unlock(&lg.wake_mutex);
+    drain();
+    return NULL;
+}
+
+int log_init(const char *path, int flush_ms, int capacity) {
+    if (lg.initialized) return 0;
+
+    unsigned long cap = 1;
+    while (cap < (unsigned long)(capacity > 0 ? capacity : LOG_DEFAULT_CAPACITY)) cap <<= 1;
+
+    lg.slots = malloc(cap * sizeof(LogSlot));
+    if (!lg.slots) return -1;
+    for (unsigned long i = 0; i < cap; i++) lg.slots[i].seq = i;
+    lg.mask = cap - 1;
+    lg.head = lg.tail = 0;
+    lg.flush_ms = flush_ms > 0 ? flush_ms : LOG_DEFAULT_FLUSH_MS;
+
+    lg.fd = open(path, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (lg.fd == -1) {
+        free(lg.slots);
+        lg.slots = NULL;
+        return -1;
+    }
+    lg.stop = 0;
+    if (pthread_create(&lg.flusher, NULL, flusher_main, NULL) != 0) {
+        close(lg.fd);
+        lg.fd = -1;
+        free(lg.slots);
+        lg.slots = NULL;
+        return -1;
+    }
+    __atomic_store_n(&lg.initialized, 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+static void lazy_init(void) {
+    if (!lg.initialized) {
+        log_init(LOGFILE, LOG_DEFAULT_FLUSH_MS, LOG_DEFAULT_CAPACITY);
+    }
+}
+
+void log_msg(const char *format, ...) {
+    if (!__atomic_load_n(&lg.initialized, __ATOMIC_ACQUIRE)) {
+        pthread_once(&lazy_once, lazy_init);
+        if (!lg.initialized) return;
+    }
+
+    // Réserver une case : échec immédiat si le tampon est plein
+    unsigned long pos = __atomic_load_n(&lg.tail, __ATOMIC_RELAXED);
+    LogSlot *slot;
+    while (1) {
+        slot = &lg.slots[pos & lg.mask];
+        unsigned long seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        long diff = (long)(seq - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&lg.tail, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            __atomic_fetch_add(&lg.dropped, 1, __ATOMIC_RELAXED);
+            return;
+        } else {
+            pos = __atomic_load_n(&lg.tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(slot->text, LOG_LINE_MAX, format, args);
+    va_end(args);
+    if (len < 0) len = 0;
+    if (len >= LOG_LINE_MAX) len = LOG_LINE_MAX - 1;
+    slot->len = len;
+
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+}
+
+void log_flush(void) {
+    if (lg.initialized) drain();
+}
+
+void log_shutdown(void) {
+    if (!lg.initialized) return;
+    pthread_mutex_lock(&lg.wake_mutex);
+    lg.stop = 1;
+    pthread_cond_signal(&lg.wake);
+    pthread_mutex_unlock(&lg.wake_mutex);
+    pthread_join(lg.flusher, NULL);
+
+    __atomic_store_n(&lg.initialized, 0, __ATOMIC_RELEASE);
+    close(lg.fd);
+    lg.fd = -1;
+    free(lg.slots);
+    lg.slots = NULL;
+}
+
+unsigned long log_dropped(void) {
+    return __atomic_load_n(&lg.dropped, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,29 @@
+#ifndef LOG_H
+#define LOG_H
+
+#define LOGFILE "/tmp/scheduler.log"
+
+//Valeurs par défaut du journal asynchrone
+#define LOG_DEFAULT_FLUSH_MS 50   //période de vidage du tampon
+#define LOG_DEFAULT_CAPACITY 4096 //nombre de lignes en attente au maximum
+#define LOG_LINE_MAX 512          //longueur max d'une ligne (tronquée au-delà)
+
+//Démarre le journal : un fd unique ouvert en ajout et un thread de vidage
+//qui écrit les lignes par lots toutes les flush_ms millisecondes.
+//Sans appel explicite, le premier log_msg l'initialise avec les valeurs par défaut.
+int log_init(const char *path, int flush_ms, int capacity);
+
+//Ajoute une ligne au tampon sans bloquer ni faire d'appel système ;
+//si le tampon est plein, la ligne est perdue et comptée
+void log_msg(const char *format, ...);
+
+//Écrit immédiatement tout ce qui est en attente
+void log_flush(void);
+
+//Arrête le thread de vidage après un dernier vidage
+void log_shutdown(void);
+
+//Nombre de lignes perdues depuis le démarrage
+unsigned long log_dropped(void);
+
+#endif // LOG_H
@@ -305,19 +305,32 @@ int main(void) {
 // src/main.c
 #include <sys/types.h>   // pour pid_t
 #include <sys/wait.h>    // pour waitpid
+#include <sys/stat.h>    // pour stat
 #include <unistd.h>      // pour fork, getpid, sleep
 #include <signal.h>      // pour SIGSTOP
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <math.h>        // isfinite
 #include <pthread.h>     // pour pthread_t, pthread_create, pthread_detach
 
 #include "task.h"
 #include "tasks_impl.h"
 #include "queue.h"
 #include "scheduler.h"
-
-#define LOGFILE "/tmp/scheduler.log"
+#include "log.h"
+#include "output.h"
+#include "zstd_engine.h"
+#include "batch.h"
+#include "server.h"
+#include "proto.h"
+#include "latency.h"
+#include "policy.h"
+#include "estimate.h"   // ESTIMATE_STATE_PATH
+#include "fair.h"       // fair_parse_weights
+#include "sim.h"
+#include "event_loop.h" // wake_fd_signal
 
 ///// VARIABLE GLOBALE /////
 static Queue q;                   // File d’attente protégée par un mutex
@@ -342,16 +355,263 @@ void sigint_handler(int sig) {
     exit(EXIT_SUCCESS);
 }
 
-int main(void) {
-    // 1) Installer handler Ctrl+C
-    signal(SIGINT, sigint_handler);
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage : %s [--batch FICHIER|- | --daemon [--socket CHEMIN] | --simulate TRACE|-]\n"
+            "          [--algo fifo|rr|priority|mlfq|sjf|edf|fair] [--workers N] [--quantum S] [--spill]\n"
+            "          [--aging S] [--max-wait S] [--share TYPE=POIDS,...] [--trace FICHIER.json]\n"
+            "Sans option : menu interactif. Avec --batch, les tâches du manifeste\n"
+            "(voir batch.h) sont lancées au fil de la lecture, puis le programme se\n"
+            "termine quand toutes sont finies. Avec --daemon, les tâches arrivent par\n"
+            "le socket UNIX (défaut %s, client : schedctl). Dans ces deux modes,\n"
+            "SIGTERM ou Ctrl+C arrête les soumissions et termine après la dernière\n"
+            "tâche en cours ou en file.\n"
+            "--simulate rejoue une trace « arrivée(ms) type priorité durée(ms) »\n"
+            "(voir sim.h) sur une horloge virtuelle, sans lancer de tâche, et\n"
+            "affiche attente, réponse et rotation par type de tâche.\n"
+            "--quantum accepte des fractions de seconde (0.05) ; par défaut 2 s en RR,\n"
+            "200 ms en fair, 50 ms au premier niveau en MLFQ (le quantum double à\n"
+            "chaque niveau).\n"
+            "sjf lance d'abord les tâches les plus courtes d'après leur type, la\n"
+            "taille de leur entrée et l'historique des exécutions (%s).\n"
+            "edf lance d'abord l'échéance la plus proche (option deadline= du\n"
+            "manifeste) et signale à la soumission les échéances intenables.\n"
+            "fair partage le CPU entre types de tâches au prorata de leur poids\n"
+            "(--share convert=1,compress=4 ; 1 par défaut) : un worker libéré va au\n"
+            "type qui a consommé le moins de CPU rapporté à son poids, et les\n"
+            "tâches sont préemptées à chaque quantum comme en rr.\n"
+            "--aging S : en priority, une tâche gagne un niveau de priorité toutes\n"
+            "les S secondes d'attente (aucun par défaut). --max-wait S : quel que\n"
+            "soit l'algorithme, une tâche prête depuis plus de S secondes passe\n"
+            "avant les autres, la plus ancienne d'abord.\n"
+            "--trace écrit la chronologie de l'ordonnancement au format Chrome\n"
+            "trace-event (chrome://tracing, Perfetto), réécrite à chaque lancement.\n"
+            "SIGUSR1 exporte les histogrammes de latence dans %s\n"
+            "(aussi écrit à la fin de chaque ordonnancement).\n",
+            prog, SCHED_SOCKET_PATH, ESTIMATE_STATE_PATH, LATENCY_DUMP_PATH);
+}
 
-    // 2) Initialiser la file
-    queue_init(&q);
+static int parse_algo(const char *s, algo_t *alg) {
+    if (strcmp(s, "fifo") == 0) *alg = ALG_FIFO;
+    else if (strcmp(s, "rr") == 0) *alg = ALG_RR;
+    else if (strcmp(s, "priority") == 0) *alg = ALG_PRIORITY;
+    else if (strcmp(s, "mlfq") == 0) *alg = ALG_MLFQ;
+    else if (strcmp(s, "sjf") == 0) *alg = ALG_SJF;
+    else if (strcmp(s, "edf") == 0) *alg = ALG_EDF;
+    else if (strcmp(s, "fair") == 0) *alg = ALG_FAIR;
+    else return -1;
+    return 0;
+}
 
-    // 3) Algorithme par défaut = FIFO
+// Secondes, éventuellement fractionnaires ("0.05"), en millisecondes (>= 1, <= max_s)
+static int parse_seconds(const char *s, double max_s, int *ms) {
+    char *end;
+    double v = strtod(s, &end);
+    if (end == s || *end != '\0' || !isfinite(v) || v < 0.001 || v > max_s) return -1;
+    *ms = (int)(v * 1000 + 0.5);
+    return 0;
+}
+
+typedef struct {
+    FILE *in;
+    const char *name;
+    long submitted;
+    long errors;
+} BatchArg;
+
+// Modes --batch et --daemon : les soumissions tiennent la file ouverte
+// (queue_hold) jusqu'à la fin du manifeste ou jusqu'à l'arrêt demandé
+static volatile sig_atomic_t stopping = 0;
+static int submit_hold = 0;
+
+static void begin_submissions(void) {
+    submit_hold = 1;
+    queue_hold(&q);
+}
+
+// Une seule fois, quel que soit l'appelant (lecteur ou handler)
+static void end_submissions(void) {
+    // échange atomique + write(eventfd) : sûr dans un handler
+    if (__atomic_exchange_n(&submit_hold, 0, __ATOMIC_ACQ_REL)) queue_release(&q);
+}
+
+// SIGTERM, et Ctrl+C hors du menu : plus de soumissions, l'ordonnanceur
+// termine les tâches en cours et en file puis s'arrête normalement
+static void stop_handler(int sig) {
+    (void)sig;
+    stopping = 1;
+    end_submissions();
+}
+
+// Thread lecteur du manifeste : l'ordonnanceur démarre sans attendre la fin du fichier
+static void *batch_reader(void *arg) {
+    BatchArg *b = arg;
+    b->submitted = batch_submit(b->in, b->name, &q, &b->errors, &stopping);
+    end_submissions();
+    return NULL;
+}
+
+// SIGUSR1 : export des histogrammes de latence au prochain réveil de l'ordonnanceur
+static void sigusr1_handler(int sig) {
+    (void)sig;
+    latency_request_dump();
+    if (q.wake_fd >= 0) wake_fd_signal(q.wake_fd);
+}
+
+// Mode --daemon : le serveur de commandes vit dans la boucle de l'ordonnanceur
+static int run_daemon(const char *path, SchedulerConfig *cfg) {
+    Server *srv = server_open(path, &q);
+    if (!srv) {
+        fprintf(stderr, "[Daemon] %s: %s\n", path, strerror(errno));
+        return EXIT_FAILURE;
+    }
+    cfg->hooks = server_hooks(srv);
+    begin_submissions(); // l'ordonnanceur attend les clients jusqu'à SIGTERM
+    signal(SIGTERM, stop_handler);
+    signal(SIGINT, stop_handler);
+    fprintf(stderr, "[Daemon] En écoute sur %s (pid=%d)\n", path, (int)getpid());
+    log_msg("[Daemon] En écoute sur %s", path);
+
+    scheduler_running = 1;
+    run_scheduler(cfg, &q);
+    server_close(srv);
+    fprintf(stderr, "[Daemon] Arrêté.\n");
+    return EXIT_SUCCESS;
+}
+
+// Mode --batch : lecture et ordonnancement en parallèle, sortie quand tout est fini
+static int run_batch(const char *path, const SchedulerConfig *cfg) {
+    BatchArg b = { stdin, "stdin", 0, 0 };
+    if (strcmp(path, "-") != 0) {
+        b.in = fopen(path, "r");
+        b.name = path;
+        if (!b.in) {
+            perror(path);
+            return EXIT_FAILURE;
+        }
+    }
+    pthread_t reader;
+    begin_submissions();
+    signal(SIGTERM, stop_handler);
+    signal(SIGINT, stop_handler);
+    if (pthread_create(&reader, NULL, batch_reader, &b) != 0) {
+        fprintf(stderr, "[Erreur] Création du thread de lecture du manifeste\n");
+        end_submissions();
+        if (b.in != stdin) fclose(b.in);
+        return EXIT_FAILURE;
+    }
+    scheduler_running = 1;
+    run_scheduler(cfg, &q);
+    if (stopping) {
+        // le lecteur peut rester bloqué sur une entrée qui n'arrive plus
+        pthread_detach(reader);
+        fprintf(stderr, "[Batch] Interrompu : lecture du manifeste abandonnée.\n");
+        return EXIT_FAILURE;
+    }
+    pthread_join(reader, NULL);
+    if (b.in != stdin) fclose(b.in);
+
+    fprintf(stderr, "[Batch] %ld tâche(s) soumise(s), %ld ligne(s) rejetée(s)\n",
+            b.submitted, b.errors);
+    return b.errors > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv) {
+    // Tâche relancée par spawn_task() dans ce binaire (synthétiques, zstd intégré)
+    if (argc > 1 && strcmp(argv[1], "--run-task") == 0) {
+        return run_task_main(argc - 2, argv + 2);
+    }
+
+    // 1) Algorithme par défaut = FIFO
     algo_t current_algo = ALG_FIFO;
-    int quantum = 2; // quantum de 2 secondes pour RR
+    int quantum_ms = 0; // --quantum ; 0 = défaut de l'algorithme (policy.h)
+    int aging_ms = 0;    // --aging ; 0 = priorités strictes
+    int max_wait_ms = 0; // --max-wait ; 0 = pas de limite
+    const char *shares = NULL; // --share ; NULL = poids égaux
+    unsigned weights[TASK_TYPE_COUNT]; // --share vérifié à la lecture
+    int workers = scheduler_default_workers(); // tâches simultanées
+    int prefork = 0; // 0 = processus créé au lancement, 1 = fork + SIGSTOP à l'ajout
+    int spill = 0;   // 1 = sortie complète de chaque tâche dans OUTPUT_SPILL_DIR
+    const char *batch = NULL; // manifeste (--batch), "-" = entrée standard
+    int daemon = 0;           // --daemon : soumissions par le socket UNIX
+    const char *socket_path = SCHED_SOCKET_PATH;
+    const char *trace_path = NULL; // --trace : chronologie Chrome trace-event
+    const char *sim_path = NULL;   // --simulate : trace rejouée hors ligne, "-" = entrée standard
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--batch") == 0 && val) {
+            batch = val;
+            i++;
+        } else if (strcmp(arg, "--simulate") == 0 && val) {
+            sim_path = val;
+            i++;
+        } else if (strcmp(arg, "--daemon") == 0) {
+            daemon = 1;
+        } else if (strcmp(arg, "--socket") == 0 && val) {
+            socket_path = val;
+            i++;
+        } else if (strcmp(arg, "--algo") == 0 && val && parse_algo(val, &current_algo) == 0) {
+            i++;
+        } else if (strcmp(arg, "--workers") == 0 && val && atoi(val) > 0) {
+            workers = atoi(val);
+            i++;
+        } else if (strcmp(arg, "--quantum") == 0 && val && parse_seconds(val, 3600, &quantum_ms) == 0) {
+            i++;
+        } else if (strcmp(arg, "--aging") == 0 && val && parse_seconds(val, 3600, &aging_ms) == 0) {
+            i++;
+        } else if (strcmp(arg, "--max-wait") == 0 && val && parse_seconds(val, 7 * 86400, &max_wait_ms) == 0) {
+            i++;
+        } else if (strcmp(arg, "--share") == 0 && val && fair_parse_weights(val, weights) == 0) {
+            shares = val;
+            i++;
+        } else if (strcmp(arg, "--trace") == 0 && val) {
+            trace_path = val;
+            i++;
+        } else if (strcmp(arg, "--spill") == 0) {
+            spill = 1;
+        } else {
+            usage(argv[0]);
+            return strcmp(arg, "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if (sim_path) {
+        // Rien n'est lancé : ni file, ni journal
+        SchedulerConfig cfg = { current_algo, quantum_ms, workers, NULL, NULL, NULL,
+                                aging_ms, max_wait_ms, shares };
+        FILE *in = strcmp(sim_path, "-") == 0 ? stdin : fopen(sim_path, "r");
+        if (!in) {
+            perror(sim_path);
+            return EXIT_FAILURE;
+        }
+        int res = sim_run(&cfg, in, in == stdin ? "stdin" : sim_path, stdout);
+        if (in != stdin) fclose(in);
+        return res == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // 2) Initialiser la file et le journal asynchrone
+    queue_init(&q);
+    signal(SIGUSR1, sigusr1_handler); // après queue_init : le handler réveille la file
+    queue_set_order(&q, policy_queue_order(current_algo));
+    // les soumissions précèdent le lancement de l'ordonnanceur : projections justes dès la première
+    queue_set_workers(&q, workers > 0 ? workers : scheduler_default_workers());
+    if (log_init(LOGFILE, LOG_DEFAULT_FLUSH_MS, LOG_DEFAULT_CAPACITY) == -1) {
+        perror("[Erreur] Initialisation du journal");
+    }
+    atexit(log_shutdown);
+
+    if (batch || daemon) {
+        SchedulerConfig cfg = { current_algo, quantum_ms, workers,
+                                spill ? OUTPUT_SPILL_DIR : NULL, NULL, trace_path,
+                                aging_ms, max_wait_ms, shares };
+        return batch ? run_batch(batch, &cfg) : run_daemon(socket_path, &cfg);
+    }
+
+    // 3) Ctrl+C : nettoyage immédiat, pour le menu seulement (l'ordonnanceur y
+    // tourne dans un thread détaché) ; --batch et --daemon ont stop_handler
+    signal(SIGINT, sigint_handler);
 
     printf("Assurez vous que les commandes suivantes sont installées :\n");
     printf("- ffmpeg (pour conversion vidéo)\n");
@@ -359,7 +619,7 @@ int main(void) {
     printf("- git (pour clonage de dépôt)\n");
     printf("Tapez la commande suivante pour installer les dépendances :\n");
     printf("sudo apt update\n");
-    printf("sudo apt install build-essential git zstd libzstd-dev ffmpeg xterm\n");
+    printf("sudo apt install build-essential git zstd libzstd-dev ffmpeg\n");
     printf("Appuyez sur Entrée pour continuer...\n");
     getchar(); // Attendre l'appui sur Entrée
     printf("Bienvenue dans l'ordonnanceur de tâches !\n");
@@ -383,12 +643,25 @@ int main(void) {
             printf("3. Choisir algorithme (actuel = FIFO)\n");
         } else if (current_algo == ALG_RR) {
             printf("3. Choisir algorithme (actuel = Round Robin RR)\n");
+        } else if (current_algo == ALG_MLFQ) {
+            printf("3. Choisir algorithme (actuel = MLFQ)\n");
+        } else if (current_algo == ALG_SJF) {
+            printf("3. Choisir algorithme (actuel = SJF)\n");
+        } else if (current_algo == ALG_EDF) {
+            printf("3. Choisir algorithme (actuel = EDF)\n");
+        } else if (current_algo == ALG_FAIR) {
+            printf("3. Choisir algorithme (actuel = FAIR)\n");
         } else {
             printf("3. Choisir algorithme (actuel = PRIORITY)\n");
         }
 
         printf("4. Lancer l'ordonnanceur\n");
         printf("5. Quitter\n");
+        printf("6. Régler la concurrence (actuel = %d tâche(s) simultanée(s))\n", workers);
+        printf("7. Mode de création des processus (actuel = %s)\n",
+               prefork ? "fork à l'ajout" : "différé au lancement");
+        printf("8. Sortie complète des tâches dans %s (actuel = %s)\n",
+               OUTPUT_SPILL_DIR, spill ? "oui" : "non");
         printf("Votre choix > ");
 
         char line[128];
@@ -416,6 +689,8 @@ int main(void) {
             task_type_t chosen_type = (task_type_t)(type_choice - 1);
 
             char *p1 = NULL, *p2 = NULL;
+            CompressOptions zopt = { COMPRESS_DEFAULT_LEVEL, COMPRESS_DEFAULT_THREADS, 0 };
+            int segments = 0;
             switch (chosen_type) {
                 case TASK_CONV_VIDEO:
                     printf("Chemin du fichier vidéo à convertir : ");
@@ -426,10 +701,19 @@ int main(void) {
                     printf("Chemin du fichier audio de sortie (ex: sortie.mp3) : ");
                     if (!fgets(line, sizeof(line), stdin)) {
                         free(p1);
+                        p1 = NULL;
                         break;
                     }
                     line[strcspn(line, "\n")] = '\0';
                     p2 = strdup(line);
+
+                    // Découpage en segments : le processus n'existe qu'au lancement
+                    if (!prefork) {
+                        printf("Segments convertis en parallèle (0 = un seul ffmpeg, Entrée = 0) : ");
+                        if (fgets(line, sizeof(line), stdin) && atoi(line) > 1) {
+                            segments = atoi(line) > 64 ? 64 : atoi(line);
+                        }
+                    }
                     break;
 
                 case TASK_COMPRESS:
@@ -439,10 +723,39 @@ int main(void) {
                     p1 = strdup(line);
 
                     {
+                        // Un dossier devient une archive tar compressée
                         char tmp[512];
-                        snprintf(tmp, sizeof(tmp), "%s.zst", p1);
+                        struct stat st;
+                        size_t len = strlen(p1);
+                        while (len > 1 && p1[len - 1] == '/') len--;
+                        if (stat(p1, &st) == 0 && S_ISDIR(st.st_mode)) {
+                            snprintf(tmp, sizeof(tmp), "%.*s.tar.zst", (int)len, p1);
+                        } else {
+                            snprintf(tmp, sizeof(tmp), "%s.zst", p1);
+                        }
                         p2 = strdup(tmp);
                     }
+
+                    printf("Niveau zstd (1-19, Entrée = %d) : ", COMPRESS_DEFAULT_LEVEL);
+                    if (fgets(line, sizeof(line), stdin) && atoi(line) > 0) {
+                        zopt.level = atoi(line) > 19 ? 19 : atoi(line);
+                    }
+                    printf("Threads de compression (0 = un par CPU, Entrée = %d) : ",
+                           COMPRESS_DEFAULT_THREADS);
+                    if (fgets(line, sizeof(line), stdin) && line[0] != '\n') {
+                        zopt.threads = atoi(line) < 0 ? 0 : atoi(line);
+                    }
+                    {
+                        // Trames indépendantes : compression et décompression parallèles
+                        struct stat st;
+                        if (zstd_engine_available() && stat(p1, &st) == 0 && S_ISREG(st.st_mode)) {
+                            printf("Format seekable : taille des trames en Mio (0 = non, Entrée = 0) : ");
+                            if (fgets(line, sizeof(line), stdin) && atoi(line) > 0) {
+                                zopt.frame_mb = atoi(line) > ZSTD_SEEKABLE_MAX_FRAME_MB
+                                               ? ZSTD_SEEKABLE_MAX_FRAME_MB : atoi(line);
+                            }
+                        }
+                    }
                     break;
 
                 case TASK_UPDATE:
@@ -457,11 +770,15 @@ int main(void) {
                     printf("Dossier de destination : ");
                     if (!fgets(line, sizeof(line), stdin)) {
                         free(p1);
+                        p1 = NULL;
                         break;
                     }
                     line[strcspn(line, "\n")] = '\0';
                     p2 = strdup(line);
                     break;
+
+                default: // types synthétiques : fichier batch uniquement
+                    break;
             }
 
             printf("Entrez la priorité (entier; plus grand = plus prioritaire) : ");
@@ -479,26 +796,58 @@ int main(void) {
                 fprintf(stderr, "[Erreur] Impossible de créer la tâche.\n");
                 continue;
             }
+            t->zopt = zopt;
+            if (segments > 1) {
+                t->seg.stage = SEG_SPLIT;
+                t->seg.count = segments;
+            }
+
+            if (!prefork) {
+                // Lancement différé : la tâche n'est qu'un descripteur,
+                // le processus sera créé par l'ordonnanceur
+                if (enqueue(&q, t) == -1) {
+                    fprintf(stderr, "[Erreur] Impossible d'enfiler la tâche.\n");
+                    free_task(t);
+                    continue;
+                }
+                printf("[Info] Tâche ajoutée : Type=%d, Prio=%d (lancement différé)\n",
+                       chosen_type, prio);
+                continue;
+            }
 
+            int out_fd = -1;
+            t->out = output_create(t, spill ? OUTPUT_SPILL_DIR : NULL, &out_fd);
             pid_t pid = fork();
             if (pid < 0) {
                 perror("[Erreur] fork échoué");
+                if (out_fd >= 0) close(out_fd);
                 free_task(t);
                 continue;
             }
             if (pid == 0) {
                 signal(SIGINT, SIG_IGN);
-                execute_task(t);
+                // Le fils se stoppe lui-même : rien de la tâche ne s'exécute avant SIGCONT
+                raise(SIGSTOP);
+                execute_task(t, out_fd);
                 _exit(0);
             } else {
+                if (out_fd >= 0) close(out_fd);
                 t->pid = pid;
                 t->state = READY;
-                kill(pid, SIGSTOP);
+                int st;
+                if (waitpid(pid, &st, WUNTRACED) == -1 || !WIFSTOPPED(st)) {
+                    fprintf(stderr, "[Erreur] Le fils PID=%d ne s'est pas stoppé.\n", pid);
+                    kill(pid, SIGKILL);
+                    waitpid(pid, NULL, 0);
+                    free_task(t);
+                    continue;
+                }
 
-                if (current_algo == ALG_PRIORITY) {
-                    enqueue_priority(&q, t);
-                } else {
-                    enqueue(&q, t);
+                if (enqueue(&q, t) == -1) {
+                    fprintf(stderr, "[Erreur] Impossible d'enfiler la tâche.\n");
+                    kill(pid, SIGKILL);
+                    free_task(t);
+                    continue;
                 }
                 printf("[Info] Tâche ajoutée : Type=%d, PID=%d, Prio=%d\n",
                        chosen_type, pid, prio);
@@ -510,15 +859,24 @@ int main(void) {
 
         } else if (choice == 3) {
             // --- 3. Choisir algorithme ---
-            printf("Choisir algorithme : 0=FIFO, 1=RR, 2=PRIORITY > ");
+            printf("Choisir algorithme : 0=FIFO, 1=RR, 2=PRIORITY, 3=MLFQ, 4=SJF, 5=EDF, 6=FAIR > ");
             if (!fgets(line, sizeof(line), stdin)) continue;
             int a = atoi(line);
-            if (a >= 0 && a <= 2) {
+            if (a >= 0 && a < ALG_COUNT) {
                 current_algo = (algo_t)a;
+                queue_set_order(&q, policy_queue_order(current_algo));
                 if (a == 0) {
                     printf("Algorithme changé en FIFO\n");
                 } else if (a == 1) {
                     printf("Algorithme changé en Round Robin RR\n");
+                } else if (a == 3) {
+                    printf("Algorithme changé en MLFQ\n");
+                } else if (a == 4) {
+                    printf("Algorithme changé en SJF\n");
+                } else if (a == 5) {
+                    printf("Algorithme changé en EDF\n");
+                } else if (a == 6) {
+                    printf("Algorithme changé en FAIR\n");
                 } else {
                     printf("Algorithme changé en PRIORITY\n");
                 }
@@ -541,26 +899,15 @@ int main(void) {
                         perror("[Erreur] Création fichier log");
                     }
 
-                    pid_t child = fork();
-                    if (child < 0) {
-                        perror("[Erreur] fork pour xterm");
-                    } else if (child == 0) {
-                        execlp("xterm", "xterm",
-                               "-T", "Watcher Ordonnanceur",
-                               "-e", "bash -c \"tail -f /tmp/scheduler.log; echo 'Fin du log. Appuyez sur Entrée pour fermer.'; read\"",
-                               (char *)NULL);
-                        perror("[Erreur] execlp xterm");
-                        _exit(EXIT_FAILURE);
-                    } else {
-                        printf("[Info] Fenêtre de log ouverte (PID=%d)\n", child);
-                    }
-
+                    SchedulerConfig cfg = { current_algo, quantum_ms, workers,
+                                            spill ? OUTPUT_SPILL_DIR : NULL, NULL, trace_path,
+                                            aging_ms, max_wait_ms, shares };
                     scheduler_running = 1;
-                    if (start_scheduler_thread(current_algo, &q, quantum) == -1) {
+                    if (start_scheduler_thread(&cfg, &q) == -1) {
                         printf("[ERREUR] Impossible de démarrer l’ordonnanceur.\n");
                         scheduler_running = 0;
                     } else {
-                        printf("[Info] Ordonnancement lancé (logs dans xterm).\n");
+                        printf("[Info] Ordonnancement lancé (suivi : ./scheduler-top, journal : %s).\n", LOGFILE);
                         printf("[Info] Retour au menu principal.\n");
                     }
                 }
@@ -572,6 +919,33 @@ int main(void) {
             sleep(1);
             break;
 
+        } else if (choice == 6) {
+            // --- 6. Régler la concurrence ---
+            printf("Nombre de tâches simultanées (0 = nb de CPU, %d) > ",
+                   scheduler_default_workers());
+            if (!fgets(line, sizeof(line), stdin)) continue;
+            int n = atoi(line);
+            if (n < 0) {
+                printf("Choix invalide\n");
+            } else {
+                workers = n > 0 ? n : scheduler_default_workers();
+                printf("Concurrence réglée à %d tâche(s)\n", workers);
+            }
+
+        } else if (choice == 7) {
+            // --- 7. Mode de création des processus ---
+            prefork = !prefork;
+            printf("Processus créés %s\n", prefork
+                   ? "à l'ajout (fork + SIGSTOP)"
+                   : "au lancement par l'ordonnanceur (posix_spawn)");
+
+        } else if (choice == 8) {
+            // --- 8. Sortie complète des tâches ---
+            spill = !spill;
+            printf("Sortie complète des tâches %s\n", spill
+                   ? "copiée dans " OUTPUT_SPILL_DIR "/task-<id>.log"
+                   : "non copiée (seule la fin est gardée dans le log)");
+
         } else {
             printf("Choix invalide, réessayez.\n");
         }
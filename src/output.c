@@ -0,0 +1,154 @@
+// src/output.c
+#define _GNU_SOURCE
+#include "output.h"
+#include "log.h"
+
+#include <sys/epoll.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#define OUTPUT_READ_CHUNK (64 * 1024)
+
+// Ajoute data à l'anneau des derniers octets
+static void tail_append(TaskOutput *o, const char *data, size_t len) {
+    if (len >= OUTPUT_TAIL_SIZE) {
+        data += len - OUTPUT_TAIL_SIZE;
+        len = OUTPUT_TAIL_SIZE;
+    }
+    size_t first = OUTPUT_TAIL_SIZE - o->head;
+    if (first > len) first = len;
+    memcpy(o->tail + o->head, data, first);
+    memcpy(o->tail, data + first, len - first);
+    o->head = (o->head + len) % OUTPUT_TAIL_SIZE;
+}
+
+// Lit tout ce qui est disponible ; retourne 0 à la fin du flux, 1 sinon
+static int output_pump(TaskOutput *o) {
+    char buf[OUTPUT_READ_CHUNK];
+    while (1) {
+        ssize_t n = read(o->fd, buf, sizeof(buf));
+        if (n > 0) {
+            tail_append(o, buf, (size_t)n);
+            o->total += (unsigned long)n;
+            if (o->spill_fd >= 0 && write(o->spill_fd, buf, (size_t)n) != n) {
+                close(o->spill_fd); // disque plein... on garde au moins la fin en mémoire
+                o->spill_fd = -1;
+            }
+            continue;
+        }
+        if (n == 0) return 0;
+        if (errno == EINTR) continue;
+        return errno == EAGAIN ? 1 : 0;
+    }
+}
+
+static void on_output_ready(void *arg, uint32_t events) {
+    (void)events;
+    TaskOutput *o = arg;
+    if (o->fd >= 0 && output_pump(o) == 0) {
+        output_close(o);
+    }
+}
+
+TaskOutput *output_create(const Task *t, const char *spill_dir, int *write_fd) {
+    TaskOutput *o = malloc(sizeof(TaskOutput));
+    if (!o) return NULL;
+    o->loop = NULL;
+    o->total = 0;
+    o->head = 0;
+    o->spill_fd = -1;
+
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) == -1) {
+        free(o);
+        return NULL;
+    }
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    o->fd = fds[0];
+    o->ev.fd = fds[0];
+    o->ev.cb = on_output_ready;
+    o->ev.arg = o;
+    *write_fd = fds[1];
+
+    if (spill_dir) {
+        char path[512];
+        mkdir(spill_dir, 0755);
+        snprintf(path, sizeof(path), "%s/task-%lu.log", spill_dir, t->id);
+        o->spill_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (o->spill_fd == -1) {
+            log_msg("[Output][ERREUR] %s: %s", path, strerror(errno));
+        }
+    }
+    return o;
+}
+
+int output_attach(TaskOutput *o, EventLoop *el) {
+    if (o->fd < 0 || o->loop) return 0;
+    if (event_loop_add(el, &o->ev, EPOLLIN) == -1) return -1;
+    o->loop = el;
+    return 0;
+}
+
+void output_close(TaskOutput *o) {
+    if (o->fd < 0) return;
+    output_pump(o);
+    if (o->loop) {
+        event_loop_del(o->loop, &o->ev);
+        o->loop = NULL;
+    }
+    close(o->fd);
+    o->fd = -1;
+    if (o->spill_fd >= 0) {
+        close(o->spill_fd);
+        o->spill_fd = -1;
+    }
+}
+
+void output_log_tail(const TaskOutput *o, pid_t pid) {
+    if (o->total == 0) return;
+
+    // Remettre l'anneau dans l'ordre
+    size_t len = o->total < OUTPUT_TAIL_SIZE ? (size_t)o->total : OUTPUT_TAIL_SIZE;
+    size_t start = (o->head + OUTPUT_TAIL_SIZE - len) % OUTPUT_TAIL_SIZE;
+    char text[OUTPUT_TAIL_SIZE + 1];
+    for (size_t i = 0; i < len; i++) {
+        text[i] = o->tail[(start + i) % OUTPUT_TAIL_SIZE];
+    }
+    text[len] = '\0';
+
+    log_msg("[pid=%d] ---- sortie (%lu octets%s) ----", pid, o->total,
+            o->total > len ? ", fin seulement" : "");
+    char *line = text;
+    if (o->total > len) {
+        // première ligne probablement coupée
+        char *nl = strchr(line, '\n');
+        line = nl ? nl + 1 : line;
+    }
+    while (*line) {
+        char *end = strchr(line, '\n');
+        if (end) *end = '\0';
+        // Barres de progression (\r) : ne garder que le dernier état
+        char *cr = strrchr(line, '\r');
+        while (cr && cr[1] == '\0' && cr > line) {
+            *cr = '\0';
+            cr = strrchr(line, '\r');
+        }
+        const char *shown = cr ? cr + 1 : line;
+        if (*shown) log_msg("[pid=%d] %s", pid, shown);
+        if (!end) break;
+        line = end + 1;
+    }
+}
+
+void output_free(TaskOutput *o) {
+    if (!o) return;
+    if (o->loop && o->fd >= 0) event_loop_del(o->loop, &o->ev);
+    if (o->fd >= 0) close(o->fd);
+    if (o->spill_fd >= 0) close(o->spill_fd);
+    free(o);
+}
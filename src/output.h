@@ -0,0 +1,39 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stddef.h>
+#include "task.h"
+#include "event_loop.h"
+
+#define OUTPUT_TAIL_SIZE (8 * 1024)        //fin de sortie gardée en mémoire par tâche
+#define OUTPUT_SPILL_DIR "/tmp/scheduler-out" //dossier des sorties complètes (optionnel)
+
+//Sortie (stdout + stderr) d'une tâche, capturée par un tube propre à la tâche
+typedef struct TaskOutput {
+    int fd;                       //extrémité lecture du tube (-1 une fois fermé)
+    int spill_fd;                 //copie complète dans un fichier (-1 si désactivé)
+    EventLoop *loop;              //boucle qui surveille fd (NULL si non attaché)
+    EventHandler ev;
+    unsigned long total;          //octets reçus
+    size_t head;                  //prochaine écriture dans tail (anneau)
+    char tail[OUTPUT_TAIL_SIZE];  //derniers octets reçus
+} TaskOutput;
+
+//Crée le tube de la tâche t ; l'extrémité écriture (à donner au fils) est
+//renvoyée dans *write_fd. Si spill_dir != NULL, tout est aussi copié dans
+//spill_dir/task-<id>.log.
+TaskOutput *output_create(const Task *t, const char *spill_dir, int *write_fd);
+
+//Surveiller le tube depuis la boucle d'événements de l'ordonnanceur
+int output_attach(TaskOutput *o, EventLoop *el);
+
+//Lire ce qui reste dans le tube puis le fermer (la fin reste en mémoire)
+void output_close(TaskOutput *o);
+
+//Écrire la fin de sortie dans le journal, une ligne par ligne de sortie
+void output_log_tail(const TaskOutput *o, pid_t pid);
+
+//Libérer (ferme les descripteurs encore ouverts)
+void output_free(TaskOutput *o);
+
+#endif // OUTPUT_H
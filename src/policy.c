@@ -0,0 +1,50 @@
+// src/policy.c
+#include "policy.h"
+
+void policy_init(Policy *pol, algo_t alg, long quantum_ms) {
+    pol->alg = alg;
+    pol->quantum_ms = quantum_ms > 0 ? quantum_ms : policy_default_quantum_ms(alg);
+}
+
+long policy_default_quantum_ms(algo_t alg) {
+    if (alg == ALG_MLFQ) return MLFQ_DEFAULT_QUANTUM_MS;
+    return alg == ALG_FAIR ? FAIR_DEFAULT_QUANTUM_MS : RR_DEFAULT_QUANTUM_MS;
+}
+
+queue_order_t policy_queue_order(algo_t alg) {
+    switch (alg) {
+        case ALG_PRIORITY: return QUEUE_ORDER_PRIORITY;
+        case ALG_MLFQ:     return QUEUE_ORDER_LEVEL;
+        case ALG_SJF:      return QUEUE_ORDER_SHORTEST;
+        case ALG_EDF:      return QUEUE_ORDER_DEADLINE;
+        case ALG_FAIR:     return QUEUE_ORDER_FAIR;
+        default:           return QUEUE_ORDER_FIFO; // FIFO et RR : ordre d'arrivée
+    }
+}
+
+// Les mises à jour et clonages ne sont jamais préemptés
+int policy_preemptible(const Policy *pol, const Task *t) {
+    return (pol->alg == ALG_RR || pol->alg == ALG_MLFQ || pol->alg == ALG_FAIR) && t
+        && t->type != TASK_UPDATE && t->type != TASK_CLONE;
+}
+
+long policy_slice_ms(const Policy *pol, const Task *t) {
+    if (!policy_preemptible(pol, t)) return 0;
+    return pol->alg == ALG_MLFQ ? pol->quantum_ms << t->level : pol->quantum_ms;
+}
+
+int policy_expire(Policy *pol, Task *t, int waiting) {
+    // Passage consommé en entier : la tâche n'est pas interactive
+    if (pol->alg == ALG_MLFQ && t->level < MLFQ_LEVELS - 1) t->level++;
+    // Personne n'attend : inutile de stopper, on repart pour un quantum
+    return waiting;
+}
+
+long policy_boost_ms(const Policy *pol) {
+    return pol->alg == ALG_MLFQ ? pol->quantum_ms * MLFQ_BOOST_QUANTA : 0;
+}
+
+void policy_boost(Policy *pol, Task *t) {
+    (void)pol;
+    t->level = 0;
+}
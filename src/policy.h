@@ -0,0 +1,67 @@
+#ifndef POLICY_H
+#define POLICY_H
+
+#include "task.h"
+#include "queue.h"
+#include "scheduler.h"
+
+//Politique d'ordonnancement : ordre de la file, durée des passages et
+//préemption, sans aucune mécanique (processus, signaux, timers). Les mêmes
+//décisions servent à l'ordonnanceur réel (scheduler.c) et au simulateur
+//(sim.c), qui ne diffèrent que par leur horloge.
+
+#define RR_DEFAULT_QUANTUM_MS 2000
+
+//MLFQ : une tâche arrive au niveau 0 ; chaque passage consommé en entier la
+//fait descendre d'un niveau, où le quantum double (quantum_ms << niveau). Les
+//tâches courtes finissent donc dans les premiers niveaux, devant les longues
+//qui descendent tout en bas. Toutes les MLFQ_BOOST_QUANTA fois le quantum du
+//premier niveau, tout le monde remonte au niveau 0 : rien n'est affamé.
+#define MLFQ_LEVELS 4
+#define MLFQ_DEFAULT_QUANTUM_MS 50
+#define MLFQ_BOOST_QUANTA 200
+
+//SJF : la file sort par durée estimée croissante (estimate.h), sans préemption ;
+//l'estimation d'une tâche est figée à son entrée dans la file.
+
+//EDF : la file sort par échéance la plus proche, les tâches sans échéance
+//passent après, par ordre d'arrivée ; pas de préemption non plus. La file
+//projette la fin de chaque soumission (queue_projected_end) pour avertir
+//quand une échéance paraît intenable.
+
+//FAIR : préemptif comme RR, mais le worker libéré revient toujours au type de
+//tâche qui a reçu le moins de CPU au regard de son poids (fair.h) ; quantum
+//plus court que RR pour que les parts s'équilibrent vite.
+#define FAIR_DEFAULT_QUANTUM_MS 200
+
+typedef struct {
+    algo_t alg;
+    long quantum_ms; //RR : durée d'un passage ; MLFQ : celle du niveau 0
+} Policy;
+
+void policy_init(Policy *pol, algo_t alg, long quantum_ms);
+
+//Quantum par défaut de l'algorithme en ms
+long policy_default_quantum_ms(algo_t alg);
+
+//Ordre de sortie de la file pour l'algorithme
+queue_order_t policy_queue_order(algo_t alg);
+
+//1 si t peut être préemptée (RR, MLFQ et FAIR, sauf mises à jour et clonages)
+int policy_preemptible(const Policy *pol, const Task *t);
+
+//Durée en ms du passage qui commence pour t (0 : jusqu'à sa fin)
+long policy_slice_ms(const Policy *pol, const Task *t);
+
+//Passage de t consommé en entier ; waiting : une tâche en attente doit prendre
+//sa place (n'importe laquelle, ou en FAIR queue_fair_should_preempt()).
+//Retourne 1 si t doit retourner dans la file, 0 si elle repart pour un passage.
+int policy_expire(Policy *pol, Task *t, int waiting);
+
+//Période de remontée des tâches en ms (0 : aucune)
+long policy_boost_ms(const Policy *pol);
+
+//Remontée de t, en cours ou en file (la file doit être réorganisée ensuite)
+void policy_boost(Policy *pol, Task *t);
+
+#endif // POLICY_H
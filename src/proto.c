@@ -0,0 +1,89 @@
+// src/proto.c
+#include "proto.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/socket.h>  // send, MSG_NOSIGNAL
+
+void proto_put_u32(unsigned char *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+void proto_put_u64(unsigned char *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+uint32_t proto_get_u32(const unsigned char *p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+uint64_t proto_get_u64(const unsigned char *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+static int send_all(int fd, const void *buf, size_t len) {
+    const char *p = buf;
+    while (len > 0) {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n == -1 && errno == EINTR) continue;
+        if (n == -1) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int recv_all(int fd, void *buf, size_t len) {
+    char *p = buf;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n == -1 && errno == EINTR) continue;
+        if (n <= 0) {
+            if (n == 0) errno = ECONNRESET;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+int proto_send(int fd, uint8_t code, const void *payload, size_t len) {
+    if (len + 1 > PROTO_MAX_FRAME) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    unsigned char head[5];
+    proto_put_u32(head, (uint32_t)(len + 1));
+    head[4] = code;
+    if (send_all(fd, head, sizeof(head)) == -1) return -1;
+    return len > 0 ? send_all(fd, payload, len) : 0;
+}
+
+int proto_recv(int fd, uint8_t *code, unsigned char **payload, size_t *len) {
+    unsigned char head[5];
+    if (recv_all(fd, head, sizeof(head)) == -1) return -1;
+    uint32_t size = proto_get_u32(head);
+    if (size == 0 || size > PROTO_MAX_FRAME) {
+        errno = EPROTO;
+        return -1;
+    }
+    *code = head[4];
+    *len = size - 1;
+    *payload = malloc(*len + 1);
+    if (!*payload) return -1;
+    if (recv_all(fd, *payload, *len) == -1) {
+        free(*payload);
+        *payload = NULL;
+        return -1;
+    }
+    (*payload)[*len] = '\0';
+    return 0;
+}
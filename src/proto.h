@@ -0,0 +1,39 @@
+#ifndef PROTO_H
+#define PROTO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+//Protocole du socket UNIX du mode démon
+//Trame : longueur du corps (u32 little-endian) puis le corps
+//Requête : opcode (1 octet) + charge ; réponse : statut (1 octet) + charge
+#define SCHED_SOCKET_PATH "/tmp/scheduler.sock"
+#define PROTO_MAX_FRAME (16 * 1024 * 1024)
+
+typedef enum {
+    OP_SUBMIT = 'S',   //une ligne de manifeste (batch.h) -> u64 id [+ avertissement d'échéance, texte]
+    OP_BATCH = 'B',    //lignes de manifeste -> u32 n puis n x u64 id (0 : ligne ignorée ou rejetée)
+    OP_CANCEL = 'C',   //u64 id
+    OP_PRIORITY = 'P', //u64 id, i32 priorité
+    OP_STATUS = 'Q',   //-> texte : tâches en cours puis file
+    OP_LATENCY = 'L'   //-> JSON : histogrammes de latence (latency.h)
+} proto_op_t;
+
+typedef enum {
+    ST_OK = 0,
+    ST_BAD_REQUEST = 1, //requête mal formée ou ligne invalide (charge : message)
+    ST_NOT_FOUND = 2,   //tâche inconnue, terminée ou pas encore lancée à part
+    ST_UNAVAILABLE = 3  //démon en cours d'arrêt
+} proto_status_t;
+
+void proto_put_u32(unsigned char *p, uint32_t v);
+void proto_put_u64(unsigned char *p, uint64_t v);
+uint32_t proto_get_u32(const unsigned char *p);
+uint64_t proto_get_u64(const unsigned char *p);
+
+//Envoi / réception bloquants d'une trame complète (client) ; la charge reçue
+//est allouée (à libérer), terminée par un '\0' non compté dans *len
+int proto_send(int fd, uint8_t code, const void *payload, size_t len);
+int proto_recv(int fd, uint8_t *code, unsigned char **payload, size_t *len);
+
+#endif // PROTO_H
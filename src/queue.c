@@ -1,118 +1,391 @@
 #include <stdio.h>
+#include <stddef.h>     // offsetof
 #include <stdlib.h>
 #include <signal.h>
 #include <pthread.h>
+#include <unistd.h>     // close
 #include "queue.h"
+#include "event_loop.h" // wake_fd_*, monotonic_ns
+#include "estimate.h"
+
+// Ordre d'arrivée (FIFO)
+static int cmp_arrival(const Task *a, const Task *b) {
+    return (a->seq > b->seq) - (a->seq < b->seq);
+}
+
+// Priorité décroissante puis ordre d'arrivée : stable à priorité égale
+static int cmp_priority(const Task *a, const Task *b) {
+    if (a->priority != b->priority) {
+        return a->priority > b->priority ? -1 : 1;
+    }
+    return cmp_arrival(a, b);
+}
+
+// ns d'attente par niveau de priorité gagné (queue_set_aging)
+static long long aging_ns;
+
+// Bornes des priorités d'un manifeste : au-delà (schedctl prio), la clé
+// vieillie déborderait
+#define AGING_PRIO_LIMIT 1000000
+
+static long long aged_key(const Task *t) {
+    int p = t->priority;
+    if (p > AGING_PRIO_LIMIT) p = AGING_PRIO_LIMIT;
+    if (p < -AGING_PRIO_LIMIT) p = -AGING_PRIO_LIMIT;
+    return (long long)p * aging_ns - t->ready_ns;
+}
+
+// Priorité vieillie décroissante : la clé ne dépend pas de l'instant présent
+static int cmp_aged(const Task *a, const Task *b) {
+    long long ka = aged_key(a), kb = aged_key(b);
+    if (ka != kb) return ka > kb ? -1 : 1;
+    return cmp_arrival(a, b);
+}
+
+// Ancienneté dans la file (attente maximale)
+static int cmp_ready(const Task *a, const Task *b) {
+    if (a->ready_ns != b->ready_ns) return a->ready_ns < b->ready_ns ? -1 : 1;
+    return cmp_arrival(a, b);
+}
+
+// Niveau MLFQ puis ordre d'arrivée : tourniquet à l'intérieur d'un niveau
+static int cmp_level(const Task *a, const Task *b) {
+    if (a->level != b->level) return a->level < b->level ? -1 : 1;
+    return cmp_arrival(a, b);
+}
+
+// Durée estimée puis ordre d'arrivée (SJF)
+static int cmp_shortest(const Task *a, const Task *b) {
+    if (a->est_ns != b->est_ns) return a->est_ns < b->est_ns ? -1 : 1;
+    return cmp_arrival(a, b);
+}
+
+// Échéance la plus proche d'abord ; sans échéance ensuite, par arrivée (EDF)
+static int cmp_deadline(const Task *a, const Task *b) {
+    if (a->deadline_ns != b->deadline_ns) {
+        if (!a->deadline_ns || !b->deadline_ns) return a->deadline_ns ? -1 : 1;
+        return a->deadline_ns < b->deadline_ns ? -1 : 1;
+    }
+    return cmp_arrival(a, b);
+}
+
+task_cmp_fn queue_order_cmp(queue_order_t order) {
+    switch (order) {
+        case QUEUE_ORDER_PRIORITY: return aging_ns > 0 ? cmp_aged : cmp_priority;
+        case QUEUE_ORDER_LEVEL:    return cmp_level;
+        case QUEUE_ORDER_SHORTEST: return cmp_shortest;
+        case QUEUE_ORDER_DEADLINE: return cmp_deadline;
+        default:                   return cmp_arrival;
+    }
+}
+
+task_cmp_fn queue_wait_cmp(void) {
+    return cmp_ready;
+}
 
 //initialise la file à vide
 void queue_init(Queue *q) {
-    q->head = NULL;
-    q->tail = NULL;
-    q->size = 0;
+    q->inbox = NULL;
+    q->next_seq = 0;
+    q->count = 0;
+    heap_init(&q->heap, cmp_arrival);
+    heap_init_at(&q->waiting, cmp_ready, offsetof(Task, wait_idx));
+    q->max_wait_ns = 0;
+    q->order = QUEUE_ORDER_FIFO;
     pthread_mutex_init(&q->mutex, NULL);
+    q->wake_fd = wake_fd_create();
+    q->producers = 0;
+    deadline_index_init(&q->deadlines);
+    q->workers = 0;
+    q->running_ns = 0;
+    fair_init(&q->fair);
 }
 
-//enfile une tâche ne fin de file(FIFO)
-void enqueue(Queue *q, Task *t) {
-    pthread_mutex_lock(&q->mutex);
-    t->next = NULL;
-    //file vide
-    if (q->tail == NULL){
-        q->head = t;
-        q->tail = t;
-    } else {
-        q->tail->next = t;
-        q->tail = t;
+// Empile la chaîne first..last dans la boîte d'arrivée (CAS, sans verrou).
+// Pas d'ABA : le consommateur ne retire jamais un élément seul, il prend tout.
+// Retourne 1 si la boîte était vide.
+static int inbox_push(Queue *q, Task *first, Task *last) {
+    Task *head = __atomic_load_n(&q->inbox, __ATOMIC_RELAXED);
+    do {
+        last->next = head;
+    } while (!__atomic_compare_exchange_n(&q->inbox, &head, first, 1,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    return head == NULL;
+}
+
+// Verse la boîte d'arrivée dans le tas (mutex tenu) ; l'ordre de la pile
+// importe peu, le tas réordonne selon seq. L'estimation de durée se fait ici,
+// d'après l'historique le plus récent, pour que tout ordre puisse passer à SJF.
+static void inbox_drain(Queue *q) {
+    Task *t = __atomic_exchange_n(&q->inbox, NULL, __ATOMIC_ACQUIRE);
+    while (t) {
+        Task *next = t->next;
+        t->next = NULL;
+        if (!t->est_ns) t->est_ns = estimate_runtime(t->type, t->work);
+        if (heap_push(&q->heap, t) == -1
+            || (q->max_wait_ns > 0 && heap_push(&q->waiting, t) == -1)
+            || (q->order == QUEUE_ORDER_FAIR && fair_push(&q->fair, t) == -1)) {
+            heap_remove(&q->heap, t);
+            heap_remove(&q->waiting, t);
+            // plus de mémoire : le reste repart dans la boîte pour le prochain passage
+            Task *last = t;
+            t->next = next;
+            while (last->next) last = last->next;
+            inbox_push(q, t, last);
+            return;
+        }
+        t = next;
+    }
+}
+
+//enfile une tâche ; elle passe après toutes celles déjà présentes à clé égale
+int enqueue(Queue *q, Task *t) {
+    long long now = monotonic_ns();
+    if (!t->enqueue_ns) {
+        t->enqueue_ns = now;
+        // stat éventuel côté soumetteur, pas dans le thread ordonnanceur
+        if (!t->work) t->work = estimate_work(t);
+        if (t->deadline_ns) {
+            // l'index d'admission a besoin de l'estimation dès maintenant
+            if (!t->est_ns) t->est_ns = estimate_runtime(t->type, t->work);
+            deadline_index_insert(&q->deadlines, t); // sans place : projections optimistes
+        }
+    }
+    t->ready_ns = now;
+    t->seq = __atomic_fetch_add(&q->next_seq, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&q->count, 1, __ATOMIC_RELAXED);
+    // Un réveil par lot suffit : le consommateur vide toute la boîte d'un coup
+    if (inbox_push(q, t, t) && q->wake_fd >= 0) wake_fd_signal(q->wake_fd);
+    return 0;
+}
+
+void queue_hold(Queue *q) {
+    __atomic_fetch_add(&q->producers, 1, __ATOMIC_RELAXED);
+}
+
+void queue_release(Queue *q) {
+    // Le dernier soumetteur réveille l'ordonnanceur pour qu'il puisse finir
+    if (__atomic_sub_fetch(&q->producers, 1, __ATOMIC_RELEASE) == 0 && q->wake_fd >= 0) {
+        wake_fd_signal(q->wake_fd);
     }
-    q->size++;
-    pthread_mutex_unlock(&q->mutex);
 }
 
-//Défiler: retourne la tâte, ou NULL si queue vide
+int queue_has_producers(const Queue *q) {
+    return __atomic_load_n(&q->producers, __ATOMIC_ACQUIRE) > 0;
+}
+
+//Défiler: retourne la tâche suivante selon l'ordre, ou NULL si queue vide
 Task* dequeue(Queue *q) {
+    Task *t;
+    return dequeue_batch(q, &t, 1) == 1 ? t : NULL;
+}
+
+int dequeue_batch(Queue *q, Task **out, int max) {
     pthread_mutex_lock(&q->mutex);
+    if (__atomic_load_n(&q->inbox, __ATOMIC_RELAXED)) inbox_drain(q);
+    long long overdue = q->max_wait_ns > 0 ? monotonic_ns() - q->max_wait_ns : 0;
+    int n = 0;
+    while (n < max) {
+        // attente maximale dépassée : la plus ancienne passe devant l'ordre de la file
+        Task *t = heap_peek(&q->waiting);
+        if (t && t->ready_ns <= overdue) heap_remove(&q->heap, t);
+        else if (q->order == QUEUE_ORDER_FAIR && (t = fair_peek(&q->fair))) heap_remove(&q->heap, t);
+        else if (!(t = heap_pop(&q->heap))) break;
+        heap_remove(&q->waiting, t);
+        if (q->order == QUEUE_ORDER_FAIR) fair_take(&q->fair, t);
+        if (t->deadline_ns) deadline_index_remove(&q->deadlines, t);
+        out[n++] = t;
+    }
+    pthread_mutex_unlock(&q->mutex);
+    if (n > 0) __atomic_fetch_sub(&q->count, n, __ATOMIC_RELAXED);
+    return n;
+}
 
-    if (q->head == NULL){
-        pthread_mutex_unlock(&q->mutex);
-        return NULL;
+//Vérifie si la file est vide (sans verrou)
+int queue_is_empty(const Queue *q) {
+    return __atomic_load_n(&q->count, __ATOMIC_RELAXED) == 0;
+}
+
+int queue_length(const Queue *q) {
+    return __atomic_load_n(&q->count, __ATOMIC_RELAXED);
+}
+
+// Recherche linéaire dans le tas (mutex tenu, boîte déjà vidée)
+static Task *heap_find(const Queue *q, unsigned long id) {
+    for (int i = 0; i < q->heap.size; i++) {
+        if (q->heap.items[i]->id == id) return q->heap.items[i];
     }
+    return NULL;
+}
 
-    Task *t = q->head;
-    q->head = t->next;
-    if(q->head == NULL) {
-        q->tail = NULL;
+Task *queue_remove(Queue *q, unsigned long id) {
+    pthread_mutex_lock(&q->mutex);
+    inbox_drain(q);
+    Task *t = heap_find(q, id);
+    if (t) {
+        heap_remove(&q->heap, t);
+        heap_remove(&q->waiting, t);
+        fair_remove(&q->fair, t);
+        if (t->deadline_ns) deadline_index_remove(&q->deadlines, t);
     }
-    t->next = NULL;
-    q->size--;
     pthread_mutex_unlock(&q->mutex);
+    if (t) __atomic_fetch_sub(&q->count, 1, __ATOMIC_RELAXED);
     return t;
 }
 
-//Vérifie si la file est vide
-int queue_is_empty(const Queue *q) {
-    pthread_mutex_lock((pthread_mutex_t*)&q->mutex);
-    int empty = (q->head == NULL);
-    pthread_mutex_unlock((pthread_mutex_t*)&q->mutex);
-    return empty;
+int queue_set_priority(Queue *q, unsigned long id, int priority) {
+    pthread_mutex_lock(&q->mutex);
+    inbox_drain(q);
+    Task *t = heap_find(q, id);
+    if (t) {
+        t->priority = priority;
+        heap_update(&q->heap, t);
+    }
+    pthread_mutex_unlock(&q->mutex);
+    return t ? 0 : -1;
 }
 
-//Afficher les tâches de la file
-void print_queue(const Queue *q) {
-    pthread_mutex_lock((pthread_mutex_t*)&q->mutex);
-    printf("===== Contenu de la file (taille=%d) =====\n", q->size);
-    Task *cursor = q->head;
-    while (cursor) {
-        print_task(cursor);
-        cursor = cursor->next;
+void queue_set_order(Queue *q, queue_order_t order) {
+    pthread_mutex_lock(&q->mutex);
+    inbox_drain(q);
+    // classes reconstruites en ordre FAIR, vidées sinon
+    fair_clear(&q->fair);
+    for (int i = 0; i < q->heap.size && order == QUEUE_ORDER_FAIR; i++) {
+        if (fair_push(&q->fair, q->heap.items[i]) == -1) {
+            // plus de mémoire : ordre d'arrivée, sans partage
+            fair_clear(&q->fair);
+            order = QUEUE_ORDER_FIFO;
+        }
     }
-    printf("=======================================\n");
-    pthread_mutex_unlock((pthread_mutex_t*)&q->mutex);
+    q->order = order;
+    // même ordre : le taux de vieillissement a pu changer
+    heap_set_cmp(&q->heap, queue_order_cmp(order));
+    pthread_mutex_unlock(&q->mutex);
 }
 
-//Fonction vide pour l'instant
-void enqueue_priority(Queue *q, Task *t) {
+void queue_set_shares(Queue *q, const unsigned *weight, long long slice_ns) {
     pthread_mutex_lock(&q->mutex);
-    if (q->head == NULL) {
-        //file vide
-        t->next = NULL;
-        q->head = t;
-        q->tail = t;
-    } else if (t->priority > q->head->priority) {
-        //inserer en tête
-        t->next = q->head;
-        q->head = t;
-    } else {
-        Task *curr = q->head;
-        while (curr->next != NULL && curr->next->priority >= t->priority) {
-            curr = curr->next;
-        }
-        t->next = curr->next;
-        curr->next = t;
-        if (t->next == NULL) {
-            q->tail = t;
+    fair_configure(&q->fair, weight, slice_ns);
+    pthread_mutex_unlock(&q->mutex);
+}
+
+void queue_fair_account(Queue *q, task_type_t type, long long cpu_ns, int again) {
+    pthread_mutex_lock(&q->mutex);
+    fair_account(&q->fair, type, cpu_ns, again);
+    pthread_mutex_unlock(&q->mutex);
+}
+
+int queue_fair_should_preempt(Queue *q, task_type_t type, long long cpu_ns) {
+    pthread_mutex_lock(&q->mutex);
+    if (__atomic_load_n(&q->inbox, __ATOMIC_RELAXED)) inbox_drain(q);
+    int preempt = fair_should_preempt(&q->fair, type, cpu_ns);
+    pthread_mutex_unlock(&q->mutex);
+    return preempt;
+}
+
+void queue_set_aging(long long ns) {
+    aging_ns = ns > 0 ? (ns < QUEUE_AGING_MAX_NS ? ns : QUEUE_AGING_MAX_NS) : 0;
+}
+
+int queue_set_max_wait(Queue *q, long long max_wait_ns) {
+    int res = 0;
+    pthread_mutex_lock(&q->mutex);
+    inbox_drain(q);
+    heap_destroy(&q->waiting);
+    for (int i = 0; i < q->heap.size; i++) q->heap.items[i]->wait_idx = -1;
+    q->max_wait_ns = max_wait_ns > 0 ? max_wait_ns : 0;
+    for (int i = 0; i < q->heap.size && q->max_wait_ns > 0; i++) {
+        if (heap_push(&q->waiting, q->heap.items[i]) == -1) {
+            heap_destroy(&q->waiting);
+            q->max_wait_ns = 0;
+            res = -1;
         }
     }
-    q->size++;
     pthread_mutex_unlock(&q->mutex);
+    return res;
+}
+
+void queue_reorder(Queue *q, void (*fn)(Task *t, void *arg), void *arg) {
+    pthread_mutex_lock(&q->mutex);
+    inbox_drain(q);
+    for (int i = 0; i < q->heap.size; i++) fn(q->heap.items[i], arg);
+    heap_set_cmp(&q->heap, q->heap.cmp);
+    pthread_mutex_unlock(&q->mutex);
+}
+
+void queue_set_workers(Queue *q, int workers) {
+    __atomic_store_n(&q->workers, workers, __ATOMIC_RELAXED);
+}
+
+void queue_add_running(Queue *q, long long est_ns) {
+    __atomic_fetch_add(&q->running_ns, est_ns, __ATOMIC_RELAXED);
+}
+
+long long queue_projected_end(Queue *q, Task *t) {
+    if (!t->deadline_ns || __atomic_load_n(&q->order, __ATOMIC_RELAXED) != QUEUE_ORDER_DEADLINE) return 0;
+    if (!t->work) t->work = estimate_work(t);
+    if (!t->est_ns) t->est_ns = estimate_runtime(t->type, t->work);
+    int workers = __atomic_load_n(&q->workers, __ATOMIC_RELAXED);
+    long long ahead = deadline_index_work_before(&q->deadlines, t->deadline_ns)
+                    + __atomic_load_n(&q->running_ns, __ATOMIC_RELAXED);
+    // approximation fluide : le travail devant elle se partage entre les workers
+    return monotonic_ns() + ahead / (workers > 0 ? workers : 1) + t->est_ns;
+}
+
+static task_cmp_fn print_cmp;
+
+static int print_sort_cmp(const void *a, const void *b) {
+    return print_cmp(*(Task *const *)a, *(Task *const *)b);
+}
+
+//Afficher les tâches de la file, dans l'ordre où elles seront lancées
+void print_queue(const Queue *q) {
+    fprint_queue(q, stdout);
+}
+
+void fprint_queue(const Queue *q, FILE *f) {
+    pthread_mutex_lock((pthread_mutex_t*)&q->mutex);
+    inbox_drain((Queue *)q);
+    int n = q->heap.size;
+    fprintf(f, "===== Contenu de la file (taille=%d) =====\n", n);
+    Task **sorted = malloc((size_t)(n > 0 ? n : 1) * sizeof(Task *));
+    if (sorted) {
+        for (int i = 0; i < n; i++) sorted[i] = q->heap.items[i];
+        print_cmp = q->heap.cmp;
+        qsort(sorted, (size_t)n, sizeof(Task *), print_sort_cmp);
+        for (int i = 0; i < n; i++) fprint_task(f, sorted[i]);
+        free(sorted);
+    } else {
+        for (int i = 0; i < n; i++) fprint_task(f, q->heap.items[i]);
+    }
+    if (q->order == QUEUE_ORDER_FAIR) {
+        fprintf(f, "Partage équitable (la classe de plus petit temps virtuel passe d'abord) :\n");
+        fair_fprint(&q->fair, f);
+    }
+    fprintf(f, "=======================================\n");
+    pthread_mutex_unlock((pthread_mutex_t*)&q->mutex);
 }
 
 void clear_queue(Queue *q) {
     pthread_mutex_lock(&q->mutex);
-    Task *current = q->head;
-    while (current != NULL) {
-        Task *next = current->next;
+    inbox_drain(q);
+    for (int i = 0; i < q->heap.size; i++) {
+        Task *current = q->heap.items[i];
         if (current->state != TERMINATED && current->pid > 0) {
             printf("[INFO] ➤ Suppression du fils PID=%d\n", current->pid);
             kill(current->pid, SIGKILL);
         }
         free_task(current);
-        current = next;
     }
-    q->head = NULL;
-    q->tail = NULL;
-    q->size = 0;
+    heap_destroy(&q->heap);
+    heap_destroy(&q->waiting);
+    fair_destroy(&q->fair);
+    deadline_index_destroy(&q->deadlines);
+    __atomic_store_n(&q->count, 0, __ATOMIC_RELAXED);
     pthread_mutex_unlock(&q->mutex);
 
     printf("[INFO] File d’attente libérée avec succès.\n");
     pthread_mutex_destroy(&q->mutex); // détruire le mutex
+    if (q->wake_fd >= 0) close(q->wake_fd);
+    q->wake_fd = -1;
 }
@@ -3,27 +3,119 @@
 
 #include <pthread.h>
 #include "task.h"
+#include "heap.h"
+#include "deadline.h"
+#include "fair.h"
 
-//Structure file d'attente
+//Ordre de sortie de la file
+typedef enum {
+    QUEUE_ORDER_FIFO = 0,     //ordre d'arrivée
+    QUEUE_ORDER_PRIORITY = 1, //priorité (vieillie, voir queue_set_aging) décroissante, ordre d'arrivée à égalité
+    QUEUE_ORDER_LEVEL = 2,    //niveau MLFQ croissant, ordre d'arrivée dans le niveau
+    QUEUE_ORDER_SHORTEST = 3, //durée estimée croissante (estimate.h), ordre d'arrivée à égalité
+    QUEUE_ORDER_DEADLINE = 4, //échéance la plus proche, puis les tâches sans échéance par arrivée
+    QUEUE_ORDER_FAIR = 5      //classe de plus petit temps virtuel (fair.h), ordre d'arrivée dans la classe
+} queue_order_t;
+
+//Structure file d'attente : les producteurs empilent sans verrou dans une
+//boîte d'arrivée (intrusive sur Task::next) ; le consommateur la vide d'un
+//seul échange atomique dans un tas binaire (retrait en O(log n))
 typedef struct Queue {
-    Task *head; //tête
-    Task *tail; //queue
-    int size; //nbr d'elts
-    pthread_mutex_t mutex; //mutex protégeant la file
+    Task *inbox; //pile lock-free des tâches soumises, pas encore dans le tas
+    unsigned long next_seq; //numéro d'arrivée de la prochaine tâche (atomique)
+    int count; //tâches en attente, boîte et tas confondus (atomique)
+    TaskHeap heap; //tâches prêtes, ordonnées
+    TaskHeap waiting; //les mêmes par ancienneté (ready_ns), tenu si max_wait_ns > 0
+    long long max_wait_ns; //attente au-delà de laquelle une tâche passe avant tout (0 : aucune)
+    queue_order_t order; //ordre courant
+    pthread_mutex_t mutex; //protège le tas (consommateur / affichage) ; jamais pris par enqueue
+    int wake_fd; //eventfd signalé quand la boîte d'arrivée cesse d'être vide (-1 : aucun)
+    int producers; //soumetteurs encore ouverts : l'ordonnanceur les attend (atomique)
+    DeadlineIndex deadlines; //tâches à échéance en attente (contrôle d'admission EDF)
+    int workers; //workers de l'ordonnanceur, pour les projections (atomique)
+    long long running_ns; //durées estimées des tâches en cours (atomique)
+    FairShare fair; //classes et temps virtuels, tenus en ordre FAIR
 } Queue;
 
-//prototypes pour la file (FIFO)
+//prototypes pour la file
 void queue_init(Queue *q);
-void enqueue(Queue *q, Task *t);
+int enqueue(Queue *q, Task *t);
 Task* dequeue(Queue *q);
 int queue_is_empty(const Queue *q);
+int queue_length(const Queue *q); //tâches en attente (sans verrou)
+
+//Un soumetteur s'annonce / a fini : tant qu'il en reste un, l'ordonnanceur
+//attend de nouvelles tâches au lieu de s'arrêter sur une file vide
+void queue_hold(Queue *q);
+void queue_release(Queue *q);
+int queue_has_producers(const Queue *q);
+
+//Retire jusqu'à max tâches dans l'ordre en un seul passage ; retourne leur nombre
+int dequeue_batch(Queue *q, Task **out, int max);
 void print_queue(const Queue *q);
+void fprint_queue(const Queue *q, FILE *f);
+
+//Retirer une tâche en attente par son id (NULL si elle n'est pas dans la file)
+Task *queue_remove(Queue *q, unsigned long id);
+
+//Changer la priorité d'une tâche en attente (-1 si elle n'est pas dans la file)
+int queue_set_priority(Queue *q, unsigned long id, int priority);
+
+//Comparateur du tas pour un ordre de sortie (aussi utilisé par le simulateur)
+task_cmp_fn queue_order_cmp(queue_order_t order);
+
+//Comparateur du tas d'ancienneté (attente maximale), idem
+task_cmp_fn queue_wait_cmp(void);
+
+//Changer l'ordre de sortie (réorganise la file en O(n))
+void queue_set_order(Queue *q, queue_order_t order);
+
+//Vieillissement de l'ordre PRIORITY : une tâche gagne un niveau de priorité
+//par aging_ns d'attente (0 : priorités strictes). Priorité vieillie de a
+//> celle de b à tout instant <=> a->priority * aging_ns - a->ready_ns plus grand :
+//clé fixe, le tas reste valable sans jamais être reparcouru. Taux commun à
+//toutes les files du processus (et au simulateur), plafonné à
+//QUEUE_AGING_MAX_NS ; prend effet au prochain queue_set_order.
+#define QUEUE_AGING_MAX_NS 3600000000000LL //1 h par niveau
+void queue_set_aging(long long aging_ns);
+
+//Attente maximale, quel que soit l'ordre : une tâche prête depuis plus de
+//max_wait_ns sort avant toutes les autres, la plus ancienne d'abord (0 :
+//aucune). Tient un second tas par ancienneté : O(log n) de plus par tâche.
+//-1 si plus de mémoire (la limite n'est alors pas appliquée).
+int queue_set_max_wait(Queue *q, long long max_wait_ns);
+
+//Applique fn à chaque tâche en attente puis réorganise la file en O(n)
+//(clés modifiées en bloc, ex. remontée MLFQ)
+void queue_reorder(Queue *q, void (*fn)(Task *t, void *arg), void *arg);
+
+//Partage équitable (ordre FAIR) : poids des classes (NULL : égaux) et passage
+//prélevé d'avance sur une classe à chaque tâche retirée de la file
+void queue_set_shares(Queue *q, const unsigned *weight, long long slice_ns);
+
+//Fin d'un passage d'une tâche de type sorti de la file en ordre FAIR, qui a
+//consommé cpu_ns de CPU ; again : elle repart pour un passage sans repasser
+//par la file. Chaque tâche retirée doit être soldée ainsi une fois (cpu_ns = 0
+//si elle n'a pas tourné).
+void queue_fair_account(Queue *q, task_type_t type, long long cpu_ns, int again);
+
+//Ordre FAIR : 1 si une tâche de type arrivée au bout d'un passage de cpu_ns
+//de CPU doit céder son worker (fair_should_preempt) ; 0 si sa classe reste la
+//moins servie ou si rien n'attend
+int queue_fair_should_preempt(Queue *q, task_type_t type, long long cpu_ns);
 
+//Capacité vue par le contrôle d'admission : nombre de workers, et durées
+//estimées des tâches lancées (l'ordonnanceur ajoute au lancement, retire à la fin)
+void queue_set_workers(Queue *q, int workers);
+void queue_add_running(Queue *q, long long est_ns);
 
-//prototype pour insertion triée par priorité
-void enqueue_priority(Queue *q, Task *t);
+//Fin prévue (monotonic_ns) de t si elle entrait maintenant dans la file en
+//ordre EDF : les tâches en cours et celles d'échéance <= la sienne passent
+//d'abord, réparties sur les workers. 0 si t n'a pas d'échéance ou si la file
+//n'est pas en ordre EDF. À appeler avant enqueue (t->est_ns est renseigné).
+long long queue_projected_end(Queue *q, Task *t);
 
 //Tuer la queue
 void clear_queue(Queue *q);
 
-#endif // QUEUE_H
\ No newline at end of file
+#endif // QUEUE_H
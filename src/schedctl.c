@@ -0,0 +1,200 @@
+// src/schedctl.c
+// Client du mode démon : schedctl [-s SOCKET] COMMANDE ...
+#include "proto.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define BATCH_CHUNK (1024 * 1024) // lignes envoyées par requête OP_BATCH
+
+static void usage(void) {
+    fprintf(stderr,
+            "Usage : schedctl [-s SOCKET] COMMANDE\n"
+            "  submit TYPE PRIO [PARAM1 [PARAM2 [OPTIONS]]]   affiche l'id de la tâche\n"
+            "  batch FICHIER|-                                 manifeste (voir batch.h)\n"
+            "  cancel ID\n"
+            "  prio ID PRIO\n"
+            "  status\n"
+            "  latency                                         histogrammes de latence (JSON)\n"
+            "Socket par défaut : %s\n", SCHED_SOCKET_PATH);
+}
+
+static int connect_to(const char *path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "schedctl: chemin de socket trop long\n");
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1) {
+        fprintf(stderr, "schedctl: %s: %s\n", path, strerror(errno));
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Requête puis réponse ; les erreurs du démon sont affichées ici
+static int call(int fd, uint8_t op, const void *req, size_t len,
+                unsigned char **resp, size_t *resp_len) {
+    uint8_t status;
+    if (proto_send(fd, op, req, len) == -1 || proto_recv(fd, &status, resp, resp_len) == -1) {
+        fprintf(stderr, "schedctl: %s\n", strerror(errno));
+        return -1;
+    }
+    if (status != ST_OK) {
+        const char *what = status == ST_NOT_FOUND ? "tâche introuvable"
+                         : status == ST_UNAVAILABLE ? "démon indisponible" : "requête refusée";
+        fprintf(stderr, "schedctl: %s%s%s\n", what, *resp_len ? " : " : "", (char *)*resp);
+        free(*resp);
+        *resp = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+static int cmd_submit(int fd, int argc, char **argv) {
+    // Même ligne que dans un manifeste : champs séparés par des tabulations
+    size_t len = 0;
+    for (int i = 0; i < argc; i++) len += strlen(argv[i]) + 1;
+    char *line = malloc(len + 1);
+    if (!line) return -1;
+    line[0] = '\0';
+    for (int i = 0; i < argc; i++) {
+        if (i > 0) strcat(line, "\t");
+        strcat(line, argv[i]);
+    }
+    unsigned char *resp;
+    size_t resp_len;
+    int res = call(fd, OP_SUBMIT, line, strlen(line), &resp, &resp_len);
+    free(line);
+    if (res == -1) return -1;
+    if (resp_len >= 8) printf("%llu\n", (unsigned long long)proto_get_u64(resp));
+    // admise, mais l'échéance paraît intenable (charge terminée par '\0')
+    if (resp_len > 8) fprintf(stderr, "schedctl: attention, %s\n", (char *)resp + 8);
+    free(resp);
+    return 0;
+}
+
+// Envoie un lot de lignes ; lineno = numéro de la première
+static int send_chunk(int fd, const char *buf, size_t len, long lineno,
+                      long *submitted, long *rejected) {
+    unsigned char *resp;
+    size_t resp_len;
+    if (call(fd, OP_BATCH, buf, len, &resp, &resp_len) == -1) return -1;
+    uint32_t n = resp_len >= 4 ? proto_get_u32(resp) : 0;
+    const char *line = buf;
+    for (uint32_t i = 0; i < n && 4 + (size_t)(i + 1) * 8 <= resp_len; i++) {
+        const char *end = memchr(line, '\n', (size_t)(buf + len - line));
+        size_t l = end ? (size_t)(end - line) : (size_t)(buf + len - line);
+        if (proto_get_u64(resp + 4 + (size_t)i * 8) != 0) {
+            (*submitted)++;
+        } else if (l > 0 && line[0] != '#' && !(l == 1 && line[0] == '\r')) {
+            fprintf(stderr, "schedctl: ligne %ld rejetée\n", lineno + (long)i);
+            (*rejected)++;
+        }
+        line = end ? end + 1 : line + l;
+    }
+    free(resp);
+    return 0;
+}
+
+static int cmd_batch(int fd, const char *path) {
+    FILE *in = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (!in) {
+        perror(path);
+        return -1;
+    }
+    char *chunk = malloc(BATCH_CHUNK);
+    char *line = NULL;
+    size_t cap = 0, used = 0;
+    ssize_t len;
+    long lineno = 1, first = 1, submitted = 0, rejected = 0;
+    int res = chunk ? 0 : -1;
+    while (res == 0 && (len = getline(&line, &cap, in)) != -1) {
+        if (len > 0 && line[len - 1] != '\n') line[len++] = '\n'; // getline laisse la place du '\0'
+        if (used + (size_t)len > BATCH_CHUNK && used > 0) {
+            res = send_chunk(fd, chunk, used, first, &submitted, &rejected);
+            used = 0;
+            first = lineno;
+        }
+        if ((size_t)len > BATCH_CHUNK) {
+            fprintf(stderr, "schedctl: ligne %ld trop longue\n", lineno);
+            rejected++;
+        } else {
+            memcpy(chunk + used, line, (size_t)len);
+            used += (size_t)len;
+        }
+        lineno++;
+    }
+    if (res == 0 && used > 0) res = send_chunk(fd, chunk, used, first, &submitted, &rejected);
+    free(line);
+    free(chunk);
+    if (in != stdin) fclose(in);
+    fprintf(stderr, "%ld tâche(s) soumise(s), %ld ligne(s) rejetée(s)\n", submitted, rejected);
+    return res == 0 && rejected == 0 ? 0 : -1;
+}
+
+static int parse_id(const char *s, unsigned long long *id) {
+    char *end;
+    errno = 0;
+    *id = strtoull(s, &end, 10);
+    if (end == s || *end != '\0' || errno != 0 || *id == 0) {
+        fprintf(stderr, "schedctl: id invalide : %s\n", s);
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    const char *path = SCHED_SOCKET_PATH;
+    int i = 1;
+    if (i + 1 < argc && strcmp(argv[i], "-s") == 0) {
+        path = argv[i + 1];
+        i += 2;
+    }
+    if (i >= argc) {
+        usage();
+        return EXIT_FAILURE;
+    }
+    const char *cmd = argv[i++];
+    int nargs = argc - i;
+    char **args = argv + i;
+
+    int fd = connect_to(path);
+    if (fd == -1) return EXIT_FAILURE;
+
+    int res = -1;
+    unsigned char req[12];
+    unsigned char *resp = NULL;
+    size_t resp_len;
+    unsigned long long id;
+    if (strcmp(cmd, "submit") == 0 && nargs >= 2 && nargs <= 5) {
+        res = cmd_submit(fd, nargs, args);
+    } else if (strcmp(cmd, "batch") == 0 && nargs == 1) {
+        res = cmd_batch(fd, args[0]);
+    } else if (strcmp(cmd, "cancel") == 0 && nargs == 1 && parse_id(args[0], &id) == 0) {
+        proto_put_u64(req, id);
+        res = call(fd, OP_CANCEL, req, 8, &resp, &resp_len);
+    } else if (strcmp(cmd, "prio") == 0 && nargs == 2 && parse_id(args[0], &id) == 0) {
+        proto_put_u64(req, id);
+        proto_put_u32(req + 8, (uint32_t)atoi(args[1]));
+        res = call(fd, OP_PRIORITY, req, 12, &resp, &resp_len);
+    } else if ((strcmp(cmd, "status") == 0 || strcmp(cmd, "latency") == 0) && nargs == 0) {
+        res = call(fd, cmd[0] == 's' ? OP_STATUS : OP_LATENCY, NULL, 0, &resp, &resp_len);
+        if (res == 0) fwrite(resp, 1, resp_len, stdout);
+    } else {
+        usage();
+    }
+    free(resp);
+    close(fd);
+    return res == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,316 +1,853 @@
 // src/scheduler.c
-#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE     // wait4
 #include "scheduler.h"
 #include "task.h"
 #include "queue.h"
-
+#include "event_loop.h"
+#include "tasks_impl.h"
+#include "log.h"
+#include "output.h"
+#include "status_board.h"
+#include "usage.h"
+#include "latency.h"
+#include "trace.h"
+#include "policy.h"
+#include "estimate.h"
+#include "fair.h"
+
+#include <sys/epoll.h>  // EPOLLIN
 #include <sys/wait.h>
-#include <signal.h>     // kill, SIGCONT, SIGSTOP, SIGALRM
+#include <sys/resource.h> // struct rusage
+#include <signal.h>     // kill, SIGCONT, SIGSTOP
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
-#include <sys/time.h>   // setitimer
-#include <unistd.h>     // pause(), usleep
-#include <stdarg.h>     // va_list, va_start, va_end
-#include <fcntl.h>      // open
+#include <unistd.h>     // sysconf, read, close
 #include <errno.h>
+#include <stdint.h>
 
 // Déclarer l’externe pour pouvoir réinitialiser
 extern int scheduler_running;
 
-#define LOGFILE "/tmp/scheduler.log"
+// ====== Workers ======
+// Un worker est un emplacement d'exécution : au plus une tâche RUNNING par worker.
+// La fin du fils (pidfd) et la fin du quantum (timerfd) arrivent par la boucle
+// d'événements : le thread ordonnanceur dort tant que rien ne se passe.
+typedef struct Pool Pool;
 
-// Flag pour indiquer fin du quantum
-static volatile sig_atomic_t alarm_flag = 0;
+typedef struct {
+    Task *task;              // tâche en cours (NULL si libre)
+    int slot;                // numéro du worker
+    Pool *pool;
+    EventHandler exit_ev;    // pidfd du fils en cours (-1 : sondé)
+    EventHandler quantum_ev; // timerfd du quantum RR
+    long long slice_ns;      // début du passage en cours (trace)
+    long long freed_ns;      // worker libre depuis (latence de dispatch)
+    long long cpu_mark;      // FAIR : CPU du fils, ses fils récoltés compris, au début du passage (-1 : inconnu)
+    long long cpu_exit;      // FAIR : CPU du fils lu avant de le récolter (-1 : inconnu)
+} Worker;
+
+// ffprobe d'une conversion à découper : un fils surveillé comme ceux des
+// workers, sans en occuper un ; la tâche attend sa durée hors de la file
+typedef struct Probe {
+    Task *task;
+    Pool *pool;
+    pid_t pid;
+    int out_fd;              // sortie de ffprobe (tube)
+    EventHandler exit_ev;    // pidfd de ffprobe (-1 : sondé)
+    struct Probe *next;
+} Probe;
+
+struct Pool {
+    const SchedulerConfig *cfg;
+    Queue *q;
+    Worker *workers;
+    int n;
+    int running;             // workers occupés
+    int polled;              // workers et sondages sans pidfd (noyau < 5.3), sondés toutes les 10 ms
+    Probe *probes;           // sondages ffprobe en cours
+    Task *finished;          // tâches terminées, libérées après le lot d'événements
+    Task **batch;            // tâches retirées de la file d'un coup (n places)
+    EventHandler wake_ev;    // eventfd de la file : nouvelles soumissions
+    EventHandler boost_ev;   // timerfd de remontée MLFQ (-1 : aucune)
+    StatusBoard *board;      // état publié pour scheduler-top (NULL : pas de mémoire partagée)
+    UsageTotals usage[TASK_TYPE_COUNT]; // consommation cumulée par type de tâche
+    Trace *trace;            // chronologie Chrome trace-event (NULL : pas de trace)
+    Policy pol;              // décisions d'ordonnancement (policy.c)
+    EventLoop loop;
+};
+
+// Ordonnanceur en cours, pour les commandes venues des hooks (même thread)
+static Pool *active_pool;
+
+int scheduler_default_workers(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
 
-// Handler pour SIGALRM (préemption)
-static void sigalrm_handler(int sig) {
-    (void)sig;
-    alarm_flag = 1;
+// Préfixe des lignes de log selon l'algorithme
+static const char *algo_tag(const Policy *pol, const Task *t) {
+    switch (pol->alg) {
+        case ALG_FIFO:     return "FIFO";
+        case ALG_RR:       return policy_preemptible(pol, t) ? "RR" : "RR-NoPreempt";
+        case ALG_PRIORITY: return "PR";
+        case ALG_MLFQ:     return policy_preemptible(pol, t) ? "MLFQ" : "MLFQ-NoPreempt";
+        case ALG_SJF:      return "SJF";
+        case ALG_EDF:      return "EDF";
+        case ALG_FAIR:     return policy_preemptible(pol, t) ? "FAIR" : "FAIR-NoPreempt";
+        default:           return "??";
+    }
 }
 
-// Fonction utilitaire : écrit un message formaté dans le fichier de log
-static void log_msg(const char *format, ...) {
-    va_list args;
-    va_start(args, format);
-    FILE *f = fopen(LOGFILE, "a");
-    if (!f) {
-        va_end(args);
-        return;
+static const char *algo_name(algo_t alg) {
+    switch (alg) {
+        case ALG_FIFO:     return "FIFO";
+        case ALG_RR:       return "Round Robin";
+        case ALG_PRIORITY: return "Priority";
+        case ALG_MLFQ:     return "MLFQ";
+        case ALG_SJF:      return "SJF";
+        case ALG_EDF:      return "EDF";
+        case ALG_FAIR:     return "FAIR";
+        default:           return "??";
     }
-    vfprintf(f, format, args);
-    fprintf(f, "\n");
-    fclose(f);
-    va_end(args);
 }
 
-// Aide pour afficher le type de tâche en texte
-static const char *get_task_type_str(task_type_t type) {
-    switch (type) {
-        case TASK_CONV_VIDEO: return "Conversion";
-        case TASK_COMPRESS:   return "Compression";
-        case TASK_UPDATE:     return "MiseAJour";
-        case TASK_CLONE:      return "ClonageGit";
-        default:              return "Inconnu";
+// FAIR : CPU total du fils de w, et ce qu'il a consommé depuis le début du
+// passage ; toujours /proc/<pid>/stat, ses fils récoltés compris
+static long long slice_cpu_ns(const Worker *w, long long *cpu) {
+    const Task *t = w->task;
+    // fils récolté : dernière lecture faite avant wait4
+    *cpu = t->end_ns ? w->cpu_exit : usage_cpu_ns(t->pid);
+    return *cpu >= 0 && w->cpu_mark >= 0 ? *cpu - w->cpu_mark : 0;
+}
+
+// FAIR : solde le passage en cours sur w avec le CPU réellement consommé ;
+// again : la tâche repart pour un passage
+static void settle_share(Worker *w, int again) {
+    long long cpu;
+    long long used = slice_cpu_ns(w, &cpu);
+    queue_fair_account(w->pool->q, w->task->type, used, again);
+    w->cpu_mark = cpu;
+}
+
+// Libère le worker : plus de surveillance du fils ni de quantum
+static void release_worker(Worker *w) {
+    Pool *p = w->pool;
+    if (w->exit_ev.fd >= 0) {
+        event_loop_del(&p->loop, &w->exit_ev);
+        close(w->exit_ev.fd);
+        w->exit_ev.fd = -1;
+    } else {
+        p->polled--;
     }
+    timer_fd_arm(w->quantum_ev.fd, 0);
+    if (p->pol.alg == ALG_FAIR) settle_share(w, 0);
+    queue_add_running(p->q, -w->task->est_ns);
+    w->task = NULL;
+    w->freed_ns = monotonic_ns();
+    p->running--;
 }
 
-// ====== FIFO ======
-static void run_fifo(Queue *q) {
-    while (!queue_is_empty(q)) {
-        Task *t = dequeue(q);
-        if (!t) break;
-
-        pid_t pid = t->pid;
-        t->state = RUNNING;
-        // Deux sauts de ligne avant la reprise
-        log_msg("\n\n[FIFO] Reprise pid=%d (Type=%s, Param=\"%s\")",
-                pid,
-                get_task_type_str(t->type),
-                t->param1 ? t->param1 : "N/A");
-
-        if (kill(pid, SIGCONT) == -1) {
-            log_msg("[FIFO][ERREUR] kill SIGCONT pid=%d: %s", pid, strerror(errno));
-        }
+// Tous les segments sont terminés : l'assemblage part dans la file s'ils ont
+// tous réussi, sinon la conversion est abandonnée
+static void segments_done(Pool *p, Task *parent) {
+    if (!parent->seg.failed && enqueue(p->q, parent) == 0) return;
+    log_msg("[Scheduler][ERREUR] conversion segmentée de \"%s\" abandonnée (%s)",
+            parent->param1, parent->seg.failed ? "segment en échec" : strerror(errno));
+    segment_cleanup(parent);
+    parent->state = TERMINATED;
+    parent->next = p->finished;
+    p->finished = parent;
+}
 
-        int status;
-        if (waitpid(pid, &status, 0) == -1) {
-            log_msg("[FIFO][ERREUR] waitpid pid=%d: %s", pid, strerror(errno));
-        } else {
-            if (WIFEXITED(status)) {
-                log_msg("[FIFO] pid=%d terminé (exit=%d)",
-                        pid, WEXITSTATUS(status));
-            } else if (WIFSIGNALED(status)) {
-                log_msg("[FIFO] pid=%d tué par signal %d",
-                        pid, WTERMSIG(status));
-            }
+// Un segment (ou l'assemblage) vient de se terminer
+static void segment_finished(Pool *p, Task *t, int ok) {
+    if (t->seg.stage == SEG_CONCAT) {
+        segment_cleanup(t);
+        return;
+    }
+    if (t->seg.stage != SEG_PART) return;
+    Task *parent = t->seg.parent;
+    if (!ok) parent->seg.failed = 1;
+    if (--parent->seg.pending == 0) segments_done(p, parent);
+}
+
+// Remplace une conversion de durée duration par ses segments, mis dans la file
+// comme des tâches ordinaires ; la tâche elle-même devient l'assemblage, lancé
+// après le dernier. Retourne -1 si elle doit être convertie d'un seul tenant.
+static int split_task(Pool *p, Task *t, double duration) {
+    const char *tag = algo_tag(&p->pol, t);
+    if (duration < 0) {
+        log_msg("[%s] durée de \"%s\" inconnue, conversion d'un seul tenant", tag, t->param1);
+        return -1;
+    }
+    int count = t->seg.count;
+    if (duration / count < SEG_MIN_SECONDS) count = (int)(duration / SEG_MIN_SECONDS);
+    if (count < 2) return -1;
+
+    Task **parts = calloc((size_t)count, sizeof(Task *));
+    if (!parts) return -1;
+    double length = duration / count;
+    int i;
+    for (i = 0; i < count; i++) {
+        char *out = segment_part_path(t->param2, i);
+        parts[i] = out ? create_task(TASK_CONV_VIDEO, t->priority, t->param1, out) : NULL;
+        free(out);
+        if (!parts[i]) break;
+        parts[i]->seg.stage = SEG_PART;
+        parts[i]->seg.index = i;
+        parts[i]->seg.start = i * length;
+        // le dernier va jusqu'au bout, quelle que soit l'erreur d'arrondi
+        parts[i]->seg.length = i == count - 1 ? duration - i * length + 1.0 : length;
+        parts[i]->seg.parent = t;
+        // estimation SJF : la part du fichier que couvre le segment
+        parts[i]->work = (long long)(t->work * (parts[i]->seg.length / duration));
+        parts[i]->deadline_ns = t->deadline_ns;
+    }
+    if (i < count) {
+        while (i-- > 0) free_task(parts[i]);
+        free(parts);
+        return -1;
+    }
+    t->wait_ns += monotonic_ns() - t->ready_ns; // attente avant le découpage
+    t->seg.stage = SEG_CONCAT;
+    t->seg.count = count;
+    t->seg.pending = count;
+    t->seg.failed = 0;
+    t->work = 0; // l'assemblage ne réencode rien : durée moyenne du type
+    t->est_ns = 0;
+    log_msg("[%s] \"%s\" (%.1f s) découpé en %d segments de %.1f s", tag, t->param1,
+            duration, count, length);
+    trace_instant(p->trace, -1, "découpage", monotonic_ns(), t);
+    for (i = 0; i < count; i++) {
+        if (enqueue(p->q, parts[i]) == -1) {
+            t->seg.failed = 1;
+            t->seg.pending--;
+            free_task(parts[i]);
         }
+    }
+    free(parts);
+    if (t->seg.pending == 0) segments_done(p, t); // aucun segment n'a pu entrer dans la file
+    return 0;
+}
 
-        t->state = TERMINATED;
-        free_task(t);
+static void probe_unlink(Probe *pr) {
+    Pool *p = pr->pool;
+    for (Probe **it = &p->probes; *it; it = &(*it)->next) {
+        if (*it == pr) {
+            *it = pr->next;
+            break;
+        }
+    }
+    if (pr->exit_ev.fd >= 0) {
+        event_loop_del(&p->loop, &pr->exit_ev);
+        close(pr->exit_ev.fd);
+    } else {
+        p->polled--;
     }
-    log_msg("[INFO] FIFO terminé.");
 }
 
-// ====== Round Robin (RR) ======
-static void run_rr(Queue *q, int quantum) {
-    struct sigaction sa;
-    memset(&sa, 0, sizeof(sa));
-    sa.sa_handler = sigalrm_handler;
-    sigemptyset(&sa.sa_mask);
-    sa.sa_flags = 0;
-    if (sigaction(SIGALRM, &sa, NULL) == -1) {
-        log_msg("[RR][ERREUR] sigaction SIGALRM: %s", strerror(errno));
-        exit(EXIT_FAILURE);
-    }
-
-    while (!queue_is_empty(q)) {
-        Task *t = dequeue(q);
-        if (!t) break;
-
-        pid_t pid = t->pid;
-
-        if (t->type == TASK_UPDATE || t->type == TASK_CLONE) {
-            t->state = RUNNING;
-            log_msg("\n\n[RR-NoPreempt] Exécution sans préemption pid=%d (Type=%s, Param=\"%s\")",
-                    pid,
-                    get_task_type_str(t->type),
-                    t->param1 ? t->param1 : "N/A");
-
-            if (kill(pid, SIGCONT) == -1) {
-                log_msg("[RR-NoPreempt][ERREUR] kill SIGCONT pid=%d: %s", pid, strerror(errno));
-            }
+// Fin de ffprobe : découpage, ou retour dans la file pour une conversion d'un
+// seul tenant
+static void on_probe_exit(void *arg, uint32_t events) {
+    (void)events;
+    Probe *pr = arg;
+    Pool *p = pr->pool;
+    Task *t = pr->task;
+    int status = 0;
+    pid_t wpid;
+    while ((wpid = waitpid(pr->pid, &status, WNOHANG)) == -1 && errno == EINTR) {
+    }
+    if (wpid == 0) return; // toujours en cours
+    double duration = probe_media_read(pr->out_fd);
+    if (wpid == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) duration = -1;
+    probe_unlink(pr);
+    free(pr);
+    if (split_task(p, t, duration) == 0) return;
+    t->wait_ns += monotonic_ns() - t->ready_ns; // enqueue() repart de maintenant
+    if (enqueue(p->q, t) == 0) return;
+    log_msg("[Scheduler][ERREUR] conversion de \"%s\" abandonnée: %s", t->param1, strerror(errno));
+    t->state = TERMINATED;
+    t->next = p->finished;
+    p->finished = t;
+}
 
-            int status;
-            if (waitpid(pid, &status, 0) == -1) {
-                log_msg("[RR-NoPreempt][ERREUR] waitpid pid=%d: %s", pid, strerror(errno));
-            } else {
-                if (WIFEXITED(status)) {
-                    log_msg("[RR-NoPreempt] pid=%d terminé (exit=%d)",
-                            pid, WEXITSTATUS(status));
-                } else if (WIFSIGNALED(status)) {
-                    log_msg("[RR-NoPreempt] pid=%d tué par signal %d",
-                            pid, WTERMSIG(status));
-                }
-            }
+// Conversion à découper : lance ffprobe sur son fichier, la suite dans
+// on_probe_exit(). Retourne -1 si elle doit être lancée d'un seul tenant.
+static int probe_task(Pool *p, Task *t) {
+    t->seg.stage = SEG_NONE;
+    if (t->pid > 0 || !t->param2) return -1;
+    Probe *pr = malloc(sizeof(*pr));
+    if (!pr) return -1;
+    pr->pid = probe_media_spawn(t->param1, &pr->out_fd);
+    if (pr->pid == -1) {
+        log_msg("[%s][ERREUR] ffprobe \"%s\": %s, conversion d'un seul tenant",
+                algo_tag(&p->pol, t), t->param1, strerror(errno));
+        free(pr);
+        return -1;
+    }
+    pr->task = t;
+    pr->pool = p;
+    pr->exit_ev.cb = on_probe_exit;
+    pr->exit_ev.arg = pr;
+    pr->exit_ev.fd = pidfd_open_compat(pr->pid);
+    if (pr->exit_ev.fd >= 0 && event_loop_add(&p->loop, &pr->exit_ev, EPOLLIN) == -1) {
+        close(pr->exit_ev.fd);
+        pr->exit_ev.fd = -1;
+    }
+    if (pr->exit_ev.fd < 0) p->polled++;
+    pr->next = p->probes;
+    p->probes = pr;
+    return 0;
+}
 
+// Lance (premier passage) ou reprend la tâche t sur le worker w.
+// Retourne -1 si le processus n'a pas pu être créé (la tâche est libérée).
+static int start_on_worker(Worker *w, Task *t) {
+    Pool *p = w->pool;
+    algo_t alg = p->pol.alg;
+    const char *tag = algo_tag(&p->pol, t);
+    int spawned = t->pid > 0;
+    // préemptée ; un fils créé à l'ajout (menu 7) existe déjà, stoppé, avant son premier passage
+    int resumed = spawned && t->start_ns;
+    long long now = monotonic_ns();
+    t->wait_ns += now - t->ready_ns;
+    if (p->cfg->max_wait_ms > 0 && now - t->ready_ns >= (long long)p->cfg->max_wait_ms * 1000000LL) {
+        log_msg("[%s] tâche %lu prête depuis %.1f s : attente maximale atteinte", tag, t->id,
+                (now - t->ready_ns) / 1e9);
+    }
+    trace_instant(p->trace, -1, resumed ? "retour en file" : "arrivée", t->ready_ns, t);
+
+    if (!spawned) {
+        // Lancement différé : le processus n'existe qu'à partir d'ici
+        int out_fd = -1;
+        t->out = output_create(t, p->cfg->output_dir, &out_fd);
+        if (!t->out) {
+            log_msg("[%s][ERREUR] tube de sortie: %s (sortie vers le log)", tag, strerror(errno));
+        }
+        t->pid = spawn_task(t, out_fd);
+        if (out_fd >= 0) close(out_fd);
+        if (t->pid == -1) {
+            log_msg("[%s][ERREUR] lancement (Type=%s, Param=\"%s\"): %s", tag,
+                    task_type_labels[t->type],
+                    t->param1 ? t->param1 : "N/A",
+                    strerror(errno));
             t->state = TERMINATED;
+            trace_instant(p->trace, w->slot, "échec du lancement", now, t);
+            if (alg == ALG_FAIR) queue_fair_account(p->q, t->type, 0, 0);
+            board_task_done(p->board, t, 127, 0);
+            segment_finished(p, t, 0);
             free_task(t);
-            continue;
+            return -1;
         }
+    }
+    if (!t->start_ns) {
+        t->start_ns = now;
+        // la réponse d'une conversion segmentée est celle de son premier segment
+        if (t->seg.stage == SEG_PART && !t->seg.parent->start_ns) t->seg.parent->start_ns = now;
+    }
+    pid_t pid = t->pid;
+
+    w->task = t;
+    w->slice_ns = now;
+    // premier lancement : le fils n'a encore rien consommé
+    w->cpu_mark = spawned ? usage_cpu_ns(pid) : 0;
+    t->state = RUNNING;
+    p->running++;
+    queue_add_running(p->q, t->est_ns);
+    board_slot_run(p->board, w->slot, t);
+    if (t->out && output_attach(t->out, &p->loop) == -1) {
+        log_msg("[%s][ERREUR] surveillance de la sortie pid=%d: %s", tag, pid, strerror(errno));
+    }
 
-        t->state = RUNNING;
-        log_msg("\n\n[RR] Reprise pid=%d (Type=%s, Param=\"%s\")",
-                pid,
-                get_task_type_str(t->type),
-                t->param1 ? t->param1 : "N/A");
+    w->exit_ev.fd = pidfd_open_compat(pid);
+    if (w->exit_ev.fd >= 0 && event_loop_add(&p->loop, &w->exit_ev, EPOLLIN) == -1) {
+        close(w->exit_ev.fd);
+        w->exit_ev.fd = -1;
+    }
+    if (w->exit_ev.fd < 0) {
+        p->polled++;
+    }
+
+    // Deux sauts de ligne avant la reprise
+    log_msg("\n\n[%s] %s pid=%d (slot=%d, Type=%s, Param=\"%s\") – priorité=%d",
+            tag, resumed ? "Reprise" : "Lancement", pid, w->slot,
+            task_type_labels[t->type],
+            t->param1 ? t->param1 : "N/A",
+            t->priority);
+    if (alg == ALG_SJF) log_msg("[%s] durée estimée %.2f s", tag, t->est_ns / 1e9);
+    if (t->deadline_ns && !resumed) {
+        log_msg("[%s] échéance dans %.1f s, durée estimée %.1f s", tag,
+                (t->deadline_ns - now) / 1e9, t->est_ns / 1e9);
+    }
 
-        if (kill(pid, SIGCONT) == -1) {
-            log_msg("[RR][ERREUR] kill SIGCONT pid=%d: %s", pid, strerror(errno));
+    if (spawned && kill(pid, SIGCONT) == -1) {
+        log_msg("[%s][ERREUR] kill SIGCONT pid=%d: %s", tag, pid, strerror(errno));
+    } else if (spawned) {
+        trace_instant(p->trace, w->slot, "SIGCONT", now, t);
+    }
+    long slice = policy_slice_ms(&p->pol, t);
+    if (slice > 0) timer_fd_arm(w->quantum_ev.fd, slice);
+    // attente imputable à l'ordonnanceur seul : la tâche prête et le worker libre
+    long long since = t->ready_ns > w->freed_ns ? t->ready_ns : w->freed_ns;
+    latency_record_dispatch(alg, t->type, monotonic_ns() - since);
+    return 0;
+}
+
+// Récolte le fils de t et relève sa consommation dans t->usage (et, si cpu,
+// son temps CPU final pour FAIR). Retourne son pid, 0 s'il tourne encore (options = WNOHANG), -1 en cas d'erreur.
+static pid_t reap_task(Pool *p, Task *t, int *status, int options, long long *cpu) {
+    siginfo_t si;
+    si.si_pid = 0;
+    // sans le récolter : /proc/<pid>/io n'existe plus après wait4
+    while (waitid(P_PID, (id_t)t->pid, &si, WEXITED | WNOWAIT | options) == -1) {
+        if (errno != EINTR) return -1;
+    }
+    if (si.si_pid == 0) return 0;
+    usage_read_proc_io(t->pid, &t->usage);
+    // FAIR : fin du dernier passage, mesurée comme les autres
+    if (cpu) *cpu = p->pol.alg == ALG_FAIR ? usage_cpu_ns(t->pid) : -1;
+    struct rusage ru;
+    pid_t wpid = wait4(t->pid, status, 0, &ru);
+    if (wpid <= 0) return -1;
+    t->end_ns = monotonic_ns();
+    usage_from_rusage(&t->usage, &ru, t->start_ns ? t->end_ns - t->start_ns : 0);
+    int ok = WIFEXITED(*status) && WEXITSTATUS(*status) == 0;
+    usage_add(&p->usage[t->type], &t->usage, ok);
+    return wpid;
+}
+
+// Fin du fils signalée par son pidfd (ou par le sondage de secours)
+static void on_child_exit(void *arg, uint32_t events) {
+    (void)events;
+    Worker *w = arg;
+    Task *t = w->task;
+    if (!t) return;
+    const char *tag = algo_tag(&w->pool->pol, t);
+
+    int status = 0;
+    pid_t wpid = reap_task(w->pool, t, &status, WNOHANG, &w->cpu_exit);
+    if (wpid == 0) return; // toujours vivant
+    int ok = wpid > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    if (t->out) {
+        output_close(t->out);
+        output_log_tail(t->out, t->pid);
+    }
+    if (wpid == -1) {
+        log_msg("[%s][ERREUR] wait4 pid=%d: %s", tag, t->pid, strerror(errno));
+    } else if (WIFEXITED(status)) {
+        log_msg("[%s] pid=%d terminé (exit=%d)", tag, t->pid, WEXITSTATUS(status));
+    } else if (WIFSIGNALED(status)) {
+        log_msg("[%s] pid=%d tué par signal %d", tag, t->pid, WTERMSIG(status));
+    }
+    if (wpid > 0) usage_log(tag, t->pid, &t->usage);
+    if (t->deadline_ns && t->end_ns > t->deadline_ns && t->seg.stage != SEG_PART) {
+        log_msg("[%s] tâche %lu terminée %.1f s après son échéance", tag, t->id,
+                (t->end_ns - t->deadline_ns) / 1e9);
+        trace_instant(w->pool->trace, w->slot, "échéance manquée", t->end_ns, t);
+    }
+    // historique des durées : temps passé sur un worker, file exclue
+    if (ok && t->seg.stage != SEG_CONCAT) {
+        long long run = t->end_ns - t->enqueue_ns - t->wait_ns;
+        estimate_record(t, run);
+        if (w->pool->pol.alg == ALG_SJF) {
+            log_msg("[%s] pid=%d : %.2f s d'exécution pour %.2f s estimées", tag, t->pid,
+                    run / 1e9, t->est_ns / 1e9);
         }
+    }
+    // les segments comptent à travers leur assemblage
+    if (wpid > 0 && t->seg.stage != SEG_PART) latency_record(w->pool->pol.alg, t);
+    t->state = TERMINATED;
+    long long end = t->end_ns ? t->end_ns : monotonic_ns();
+    trace_slice(w->pool->trace, w->slot, t, w->slice_ns, end, wpid == -1 ? "erreur" : "exit");
+    trace_instant(w->pool->trace, w->slot, "exit", end, t);
+    board_slot_free(w->pool->board, w->slot);
+    board_task_done(w->pool->board, t, wpid == -1 ? -1
+                    : WIFEXITED(status) ? WEXITSTATUS(status) : -WTERMSIG(status),
+                    t->usage.user_ns + t->usage.sys_ns);
+    release_worker(w);
+    segment_finished(w->pool, t, ok);
+    // D'autres événements du même lot peuvent encore viser sa sortie
+    t->next = w->pool->finished;
+    w->pool->finished = t;
+}
 
-        alarm_flag = 0;
-        struct itimerval timer;
-        timer.it_value.tv_sec = quantum;
-        timer.it_value.tv_usec = 0;
-        timer.it_interval.tv_sec = 0;
-        timer.it_interval.tv_usec = 0;
-        if (setitimer(ITIMER_REAL, &timer, NULL) == -1) {
-            log_msg("[RR][ERREUR] setitimer: %s", strerror(errno));
+// Quantum écoulé sur le worker (RR, MLFQ)
+static void on_quantum_expired(void *arg, uint32_t events) {
+    (void)events;
+    Worker *w = arg;
+    Pool *p = w->pool;
+    uint64_t expirations;
+    if (read(w->quantum_ev.fd, &expirations, sizeof(expirations)) == -1) return;
+
+    Task *t = w->task;
+    if (!t) return;
+    const char *tag = algo_tag(&p->pol, t);
+    long long now = monotonic_ns();
+    trace_instant(p->trace, w->slot, "quantum écoulé", now, t);
+    int waiting = !queue_is_empty(p->q);
+    if (p->pol.alg == ALG_FAIR) {
+        long long cpu;
+        waiting = queue_fair_should_preempt(p->q, t->type, slice_cpu_ns(w, &cpu));
+    }
+    if (!policy_expire(&p->pol, t, waiting)) {
+        if (p->pol.alg == ALG_FAIR) settle_share(w, 1);
+        timer_fd_arm(w->quantum_ev.fd, policy_slice_ms(&p->pol, t));
+        return;
+    }
+    if (kill(t->pid, SIGSTOP) == -1) {
+        log_msg("[%s][ERREUR] kill SIGSTOP pid=%d: %s", tag, t->pid, strerror(errno));
+    } else if (p->pol.alg == ALG_MLFQ) {
+        log_msg("[%s] Quantum écoulé pid=%d (slot=%d), préemption, niveau %d", tag, t->pid,
+                w->slot, t->level);
+        trace_instant(p->trace, w->slot, "SIGSTOP", now, t);
+    } else {
+        log_msg("[%s] Quantum écoulé pid=%d (slot=%d), préemption", tag, t->pid, w->slot);
+        trace_instant(p->trace, w->slot, "SIGSTOP", now, t);
+    }
+    trace_slice(p->trace, w->slot, t, w->slice_ns, now, "préemption");
+    t->state = READY;
+    t->preemptions++;
+    board_slot_free(p->board, w->slot);
+    release_worker(w);
+    enqueue(p->q, t);
+}
+
+static void boost_task(Task *t, void *arg) {
+    policy_boost(arg, t);
+}
+
+// Remontée périodique MLFQ : tâches en cours et en file reviennent au niveau 0
+static void on_boost(void *arg, uint32_t events) {
+    (void)events;
+    Pool *p = arg;
+    uint64_t expirations;
+    if (read(p->boost_ev.fd, &expirations, sizeof(expirations)) == -1) return;
+    for (int i = 0; i < p->n; i++) {
+        if (p->workers[i].task) policy_boost(&p->pol, p->workers[i].task);
+    }
+    if (!queue_is_empty(p->q)) {
+        queue_reorder(p->q, boost_task, &p->pol);
+        trace_instant(p->trace, -1, "remontée", monotonic_ns(), NULL);
+    }
+    timer_fd_arm(p->boost_ev.fd, policy_boost_ms(&p->pol));
+}
+
+// Des tâches sont arrivées pendant que la boucle dormait : le remplissage
+// des workers suit au tour de boucle suivant
+static void on_submit(void *arg, uint32_t events) {
+    (void)events;
+    Pool *p = arg;
+    wake_fd_drain(p->wake_ev.fd);
+}
+
+static int pool_init(Pool *p, const SchedulerConfig *cfg, Queue *q) {
+    p->cfg = cfg;
+    p->q = q;
+    policy_init(&p->pol, cfg->alg, cfg->quantum_ms);
+    p->n = cfg->workers > 0 ? cfg->workers : scheduler_default_workers();
+    queue_set_workers(q, p->n);
+    p->running = 0;
+    p->polled = 0;
+    p->probes = NULL;
+    p->finished = NULL;
+    memset(p->usage, 0, sizeof(p->usage));
+    p->workers = calloc((size_t)p->n, sizeof(Worker));
+    p->batch = malloc((size_t)p->n * sizeof(Task *));
+    if (!p->workers || !p->batch || event_loop_init(&p->loop) == -1) {
+        free(p->workers);
+        free(p->batch);
+        p->workers = NULL;
+        p->batch = NULL;
+        return -1;
+    }
+    p->boost_ev.fd = -1;
+    p->wake_ev.fd = q->wake_fd;
+    p->wake_ev.cb = on_submit;
+    p->wake_ev.arg = p;
+    if (p->wake_ev.fd >= 0 && event_loop_add(&p->loop, &p->wake_ev, EPOLLIN) == -1) {
+        p->wake_ev.fd = -1; // soumissions vues au prochain événement seulement
+    }
+    for (int i = 0; i < p->n; i++) {
+        Worker *w = &p->workers[i];
+        w->slot = i;
+        w->pool = p;
+        w->freed_ns = monotonic_ns();
+        w->exit_ev.fd = -1;
+        w->exit_ev.cb = on_child_exit;
+        w->exit_ev.arg = w;
+        w->quantum_ev.fd = timer_fd_create();
+        w->quantum_ev.cb = on_quantum_expired;
+        w->quantum_ev.arg = w;
+        if (w->quantum_ev.fd == -1
+            || event_loop_add(&p->loop, &w->quantum_ev, EPOLLIN) == -1) {
+            p->n = i + 1; // pool_destroy ne ferme que ce qui a été ouvert
+            return -1;
+        }
+    }
+    p->boost_ev.cb = on_boost;
+    p->boost_ev.arg = p;
+    if (policy_boost_ms(&p->pol) > 0) {
+        p->boost_ev.fd = timer_fd_create();
+        if (p->boost_ev.fd == -1 || event_loop_add(&p->loop, &p->boost_ev, EPOLLIN) == -1) {
+            return -1;
         }
+        timer_fd_arm(p->boost_ev.fd, policy_boost_ms(&p->pol));
+    }
+    return 0;
+}
 
-        int status;
-        while (1) {
-            pid_t wpid = waitpid(pid, &status, WNOHANG);
-            if (wpid == -1) {
-                log_msg("[RR][ERREUR] waitpid pid=%d: %s", pid, strerror(errno));
-                break;
-            }
-            if (wpid == pid) {
-                if (WIFEXITED(status)) {
-                    log_msg("[RR] pid=%d terminé (exit=%d)",
-                            pid, WEXITSTATUS(status));
-                } else if (WIFSIGNALED(status)) {
-                    log_msg("[RR] pid=%d tué par signal %d",
-                            pid, WTERMSIG(status));
-                }
-                t->state = TERMINATED;
-                timer.it_value.tv_sec = 0;
-                timer.it_value.tv_usec = 0;
-                setitimer(ITIMER_REAL, &timer, NULL);
-                free_task(t);
-                break;
-            }
-            if (alarm_flag) {
-                if (kill(pid, SIGSTOP) == -1) {
-                    log_msg("[RR][ERREUR] kill SIGSTOP pid=%d: %s", pid, strerror(errno));
-                } else {
-                    log_msg("[RR] Quantum écoulé pid=%d, préemption", pid);
-                }
-                t->state = READY;
-                timer.it_value.tv_sec = 0;
-                timer.it_value.tv_usec = 0;
-                setitimer(ITIMER_REAL, &timer, NULL);
-                enqueue(q, t);
-                break;
-            }
-            usleep(10000);
+static void pool_destroy(Pool *p) {
+    // sortie de boucle sur erreur : les sondages en cours sont abandonnés
+    while (p->probes) {
+        Probe *pr = p->probes;
+        kill(pr->pid, SIGKILL);
+        while (waitpid(pr->pid, NULL, 0) == -1 && errno == EINTR) {
         }
+        close(pr->out_fd);
+        probe_unlink(pr);
+        free_task(pr->task);
+        free(pr);
     }
-    log_msg("[INFO] Round Robin terminé.");
+    if (p->boost_ev.fd >= 0) close(p->boost_ev.fd);
+    for (int i = 0; i < p->n; i++) {
+        if (p->workers[i].exit_ev.fd >= 0) close(p->workers[i].exit_ev.fd);
+        if (p->workers[i].quantum_ev.fd >= 0) close(p->workers[i].quantum_ev.fd);
+    }
+    event_loop_close(&p->loop);
+    free(p->workers);
+    free(p->batch);
 }
 
-// ====== Ordonnancement PAR PRIORITÉ ======
-static void run_priority(Queue *q) {
-    while (!queue_is_empty(q)) {
-        pthread_mutex_lock(&q->mutex);
-        Task *prev_max = NULL;
-        Task *max_task = q->head;
-        Task *prev = q->head;
-        Task *cursor = q->head ? q->head->next : NULL;
-
-        while (cursor != NULL) {
-            if (cursor->priority > max_task->priority) {
-                max_task = cursor;
-                prev_max = prev;
-            }
-            prev = cursor;
-            cursor = cursor->next;
+// Histogrammes de latence vers LATENCY_DUMP_PATH (SIGUSR1 et fin d'ordonnancement)
+static void dump_latency(void) {
+    if (latency_dump_file(LATENCY_DUMP_PATH) == -1) {
+        log_msg("[Scheduler][ERREUR] export des latences %s: %s", LATENCY_DUMP_PATH, strerror(errno));
+    } else {
+        log_msg("[Scheduler] Latences exportées dans %s", LATENCY_DUMP_PATH);
+    }
+}
+
+// ====== Boucle commune : garde jusqu'à N tâches RUNNING ======
+static void run_pool(const SchedulerConfig *cfg, Queue *q) {
+    Pool p;
+    if (pool_init(&p, cfg, q) == -1) {
+        log_msg("[Scheduler][ERREUR] initialisation des workers: %s", strerror(errno));
+        if (p.workers) pool_destroy(&p);
+        return;
+    }
+    log_msg("[Scheduler] %d worker(s)", p.n);
+    // Créé une fois pour toutes : ensuite, publier ne coûte que des écritures en mémoire
+    p.board = board_create(p.n, cfg->alg, (int)p.pol.quantum_ms);
+    if (!p.board) {
+        log_msg("[Scheduler] tableau d'état %s indisponible: %s", STATUS_BOARD_NAME, strerror(errno));
+    }
+    p.trace = NULL;
+    if (cfg->trace_path) {
+        char name[64];
+        snprintf(name, sizeof(name), "scheduler %s", algo_name(cfg->alg));
+        p.trace = trace_open(cfg->trace_path, name, p.n);
+        if (!p.trace) {
+            log_msg("[Scheduler][ERREUR] trace %s: %s", cfg->trace_path, strerror(errno));
         }
+    }
+    active_pool = &p;
+    const SchedulerHooks *hooks = cfg->hooks;
+    if (hooks && hooks->attach(hooks->arg, &p.loop) == -1) {
+        log_msg("[Scheduler][ERREUR] extension de la boucle: %s", strerror(errno));
+        hooks = NULL;
+    }
+
+    queue_set_aging((long long)cfg->aging_ms * 1000000LL);
+    unsigned weights[TASK_TYPE_COUNT];
+    if (fair_parse_weights(cfg->shares, weights) == -1) {
+        log_msg("[Scheduler][ERREUR] poids invalides \"%s\", poids égaux", cfg->shares);
+        fair_parse_weights(NULL, weights);
+    }
+    queue_set_shares(q, weights, p.pol.quantum_ms * 1000000LL);
+    queue_set_order(q, policy_queue_order(cfg->alg));
+    if (queue_set_max_wait(q, (long long)cfg->max_wait_ms * 1000000LL) == -1) {
+        log_msg("[Scheduler][ERREUR] attente maximale: plus de mémoire, limite ignorée");
+    }
 
-        if (!max_task) {
-            pthread_mutex_unlock(&q->mutex);
+    int traced_running = -1, traced_queued = -1;
+    while (1) {
+        // Remplir les workers libres dans l'ordre de l'algorithme : un seul
+        // passage dans la file pour toutes les places libres
+        int got;
+        while (p.running < p.n && (got = dequeue_batch(q, p.batch, p.n - p.running)) > 0) {
+            int i = 0;
+            for (int k = 0; k < got; k++) {
+                Task *t = p.batch[k];
+                // conversion à découper : ses segments entreront dans la file après ffprobe
+                if (t->seg.stage == SEG_SPLIT && t->type == TASK_CONV_VIDEO && probe_task(&p, t) == 0) {
+                    if (cfg->alg == ALG_FAIR) queue_fair_account(q, t->type, 0, 0);
+                    continue;
+                }
+                while (p.workers[i].task) i++;
+                // tâche impossible à lancer : la place reste libre pour la suivante
+                start_on_worker(&p.workers[i], t);
+            }
+        }
+        int queued = queue_length(q);
+        if (p.trace && (p.running != traced_running || queued != traced_queued)) {
+            trace_counter(p.trace, monotonic_ns(), p.running, queued);
+            traced_running = p.running;
+            traced_queued = queued;
+        }
+        board_update(p.board, p.running, (unsigned long)queued);
+        // file vide, plus rien ne tourne ni ne se sonde, et plus personne pour soumettre
+        if (p.running == 0 && !p.probes && !queue_has_producers(q) && queue_is_empty(q)) break;
+
+        int timeout = -1;
+        if (p.polled > 0) timeout = 10;
+        else if (p.wake_ev.fd < 0 && queue_has_producers(q)) timeout = 100;
+        if (event_loop_wait(&p.loop, timeout) == -1) {
+            log_msg("[Scheduler][ERREUR] epoll_wait: %s", strerror(errno));
             break;
         }
-        if (prev_max == NULL) {
-            q->head = max_task->next;
-            if (q->head == NULL) {
-                q->tail = NULL;
-            }
-        } else {
-            prev_max->next = max_task->next;
-            if (prev_max->next == NULL) {
-                q->tail = prev_max;
-            }
+        if (latency_take_request()) dump_latency();
+        for (int i = 0; i < p.n && p.polled > 0; i++) {
+            Worker *w = &p.workers[i];
+            if (w->task && w->exit_ev.fd < 0) on_child_exit(w, 0);
         }
-        max_task->next = NULL;
-        q->size--;
-        pthread_mutex_unlock(&q->mutex);
-
-        pid_t pid = max_task->pid;
-        max_task->state = RUNNING;
-        log_msg("\n\n[PR] Reprise pid=%d (Type=%s, Param=\"%s\") – priorité=%d",
-                pid,
-                get_task_type_str(max_task->type),
-                max_task->param1 ? max_task->param1 : "N/A",
-                max_task->priority);
-
-        if (kill(pid, SIGCONT) == -1) {
-            log_msg("[PR][ERREUR] kill SIGCONT pid=%d: %s", pid, strerror(errno));
+        for (Probe *pr = p.probes, *next; pr && p.polled > 0; pr = next) {
+            next = pr->next;
+            if (pr->exit_ev.fd < 0) on_probe_exit(pr, 0);
         }
+        free_task_list(p.finished);
+        p.finished = NULL;
+    }
+    if (hooks) hooks->detach(hooks->arg, &p.loop);
+    usage_log_totals(p.usage);
+    dump_latency();
+    if (estimate_save() == -1) {
+        log_msg("[Scheduler][ERREUR] historique des durées %s: %s", ESTIMATE_STATE_PATH, strerror(errno));
+    }
+    active_pool = NULL;
+    board_destroy(p.board);
+    trace_close(p.trace);
+    pool_destroy(&p);
+}
+
+// ====== Commandes (hooks) ======
+static Worker *find_running(Pool *p, unsigned long id) {
+    for (int i = 0; i < p->n; i++) {
+        if (p->workers[i].task && p->workers[i].task->id == id) return &p->workers[i];
+    }
+    return NULL;
+}
 
+int scheduler_cancel(unsigned long id) {
+    Pool *p = active_pool;
+    if (!p) return -1;
+    Worker *w = find_running(p, id);
+    if (w) {
+        // tout le groupe du fils ; la fin arrive ensuite par son pidfd
+        if (kill(-w->task->pid, SIGKILL) == -1) kill(w->task->pid, SIGKILL);
+        log_msg("[Scheduler] Annulation pid=%d (tâche %lu)", w->task->pid, id);
+        return 0;
+    }
+    Task *t = queue_remove(p->q, id);
+    if (!t) return -1;
+    if (t->pid > 0) {
+        // préemptée (RR) ou créée à l'ajout : le processus stoppé existe déjà
+        if (kill(-t->pid, SIGKILL) == -1) kill(t->pid, SIGKILL);
         int status;
-        if (waitpid(pid, &status, 0) == -1) {
-            log_msg("[PR][ERREUR] waitpid pid=%d: %s", pid, strerror(errno));
-        } else {
-            if (WIFEXITED(status)) {
-                log_msg("[PR] pid=%d terminé (exit=%d)",
-                        pid, WEXITSTATUS(status));
-            } else if (WIFSIGNALED(status)) {
-                log_msg("[PR] pid=%d tué par signal %d",
-                        pid, WTERMSIG(status));
-            }
-        }
+        reap_task(p, t, &status, 0, NULL);
+    }
+    log_msg("[Scheduler] Tâche %lu retirée de la file", id);
+    trace_instant(p->trace, -1, "annulée", monotonic_ns(), t);
+    t->state = TERMINATED;
+    board_task_done(p->board, t, -SIGKILL, t->usage.user_ns + t->usage.sys_ns);
+    segment_finished(p, t, 0);
+    // sa sortie peut encore avoir un événement dans le lot en cours
+    t->next = p->finished;
+    p->finished = t;
+    return 0;
+}
+
+int scheduler_set_priority(unsigned long id, int priority) {
+    Pool *p = active_pool;
+    if (!p) return -1;
+    Worker *w = find_running(p, id);
+    if (w) {
+        w->task->priority = priority;
+        return 0;
+    }
+    return queue_set_priority(p->q, id, priority);
+}
 
-        max_task->state = TERMINATED;
-        free_task(max_task);
+void scheduler_fprint_status(FILE *f) {
+    Pool *p = active_pool;
+    if (!p) return;
+    fprintf(f, "===== En cours (%d/%d workers) =====\n", p->running, p->n);
+    for (int i = 0; i < p->n; i++) {
+        if (p->workers[i].task) fprint_task(f, p->workers[i].task);
     }
-    log_msg("[INFO] PRIORITY terminé.");
+    fprint_queue(p->q, f);
+    usage_fprint_totals(f, p->usage);
 }
 
 // ====== run_scheduler et thread ======
-void run_scheduler(algo_t alg, Queue *q, int quantum) {
-    if (alg == ALG_FIFO) {
+void run_scheduler(const SchedulerConfig *cfg, Queue *q) {
+    if (cfg->alg == ALG_FIFO) {
         log_msg("[Scheduler] Algorithme: FIFO");
-        run_fifo(q);
-    } else if (alg == ALG_RR) {
-        log_msg("[Scheduler] Algorithme: Round Robin");
-        run_rr(q, quantum);
-    } else if (alg == ALG_PRIORITY) {
+    } else if (cfg->alg == ALG_RR) {
+        log_msg("[Scheduler] Algorithme: Round Robin (quantum=%d ms)",
+                cfg->quantum_ms > 0 ? cfg->quantum_ms : RR_DEFAULT_QUANTUM_MS);
+    } else if (cfg->alg == ALG_PRIORITY && cfg->aging_ms > 0) {
+        log_msg("[Scheduler] Algorithme: Priority (+1 niveau toutes les %d ms d'attente)", cfg->aging_ms);
+    } else if (cfg->alg == ALG_PRIORITY) {
         log_msg("[Scheduler] Algorithme: Priority");
-        run_priority(q);
+    } else if (cfg->alg == ALG_EDF) {
+        log_msg("[Scheduler] Algorithme: EDF (échéance la plus proche d'abord)");
+    } else if (cfg->alg == ALG_SJF) {
+        log_msg("[Scheduler] Algorithme: SJF (durées estimées, historique dans %s)", ESTIMATE_STATE_PATH);
+    } else if (cfg->alg == ALG_FAIR) {
+        log_msg("[Scheduler] Algorithme: FAIR (partage du CPU entre types, quantum=%d ms, poids %s)",
+                cfg->quantum_ms > 0 ? cfg->quantum_ms : FAIR_DEFAULT_QUANTUM_MS,
+                cfg->shares ? cfg->shares : "égaux");
+    } else if (cfg->alg == ALG_MLFQ) {
+        int quantum = cfg->quantum_ms > 0 ? cfg->quantum_ms : MLFQ_DEFAULT_QUANTUM_MS;
+        log_msg("[Scheduler] Algorithme: MLFQ (%d niveaux, quantum=%d ms au niveau 0, "
+                "remontée toutes les %d ms)", MLFQ_LEVELS, quantum, quantum * MLFQ_BOOST_QUANTA);
     } else {
-        log_msg("[Scheduler][ERREUR] Algorithme inconnu: %d", alg);
+        log_msg("[Scheduler][ERREUR] Algorithme inconnu: %d", cfg->alg);
+        scheduler_running = 0;
+        return;
+    }
+    if (cfg->max_wait_ms > 0) {
+        log_msg("[Scheduler] Attente maximale: %d ms, puis passage avant les autres tâches", cfg->max_wait_ms);
     }
+    run_pool(cfg, q);
     log_msg("[INFO] Ordonnancement terminé.");
     // À la fin, on remet la variable à 0
     scheduler_running = 0;
 }
 
 typedef struct {
-    algo_t alg;
+    SchedulerConfig cfg;
     Queue *q;
-    int quantum;
 } SchedulerArg;
 
 void *scheduler_thread_func(void *arg) {
     SchedulerArg *sarg = (SchedulerArg *)arg;
-    run_scheduler(sarg->alg, sarg->q, sarg->quantum);
+    run_scheduler(&sarg->cfg, sarg->q);
     free(sarg);
     return NULL;
 }
 
-int start_scheduler_thread(algo_t alg, Queue *q, int quantum) {
+int start_scheduler_thread(const SchedulerConfig *cfg, Queue *q) {
     pthread_t tid;
     SchedulerArg *sarg = malloc(sizeof(SchedulerArg));
     if (!sarg) {
         perror("[Scheduler] malloc SchedulerArg");
         return -1;
     }
-    sarg->alg = alg;
+    sarg->cfg = *cfg;
     sarg->q = q;
-    sarg->quantum = quantum;
 
     int res = pthread_create(&tid, NULL, scheduler_thread_func, sarg);
     if (res != 0) {
@@ -320,5 +857,4 @@ int start_scheduler_thread(algo_t alg, Queue *q, int quantum) {
     }
     pthread_detach(tid);
     return 0;
-}
-
+}
\ No newline at end of file
@@ -7,13 +7,55 @@
 typedef enum {
     ALG_FIFO = 0,
     ALG_RR = 1,
-    ALG_PRIORITY = 2
+    ALG_PRIORITY = 2,
+    ALG_MLFQ = 3,    //files à plusieurs niveaux avec rétrogradation (policy.h)
+    ALG_SJF = 4,     //plus courte durée estimée d'abord (estimate.h)
+    ALG_EDF = 5,     //échéance la plus proche d'abord (Task::deadline_ns)
+    ALG_FAIR = 6     //partage proportionnel du CPU entre types de tâches (fair.h)
 } algo_t;
 
+#define ALG_COUNT 7
+
+struct EventLoop;
+
+//Extension greffée sur la boucle d'événements de l'ordonnanceur (serveur de
+//commandes du mode démon) : ses callbacks tournent dans le thread ordonnanceur
+typedef struct {
+    int (*attach)(void *arg, struct EventLoop *loop);
+    void (*detach)(void *arg, struct EventLoop *loop);
+    void *arg;
+} SchedulerHooks;
+
+//Paramètres de l'ordonnanceur
+typedef struct {
+    algo_t alg; //algorithme de choix de la prochaine tâche
+    int quantum_ms; //quantum RR (MLFQ : du premier niveau) en millisecondes
+    int workers; //nombre de tâches RUNNING simultanées (<= 0 : nb de CPU en ligne)
+    const char *output_dir; //copie complète de la sortie de chaque tâche (NULL : fin en mémoire seulement)
+    const SchedulerHooks *hooks; //extension de la boucle d'événements (NULL : aucune)
+    const char *trace_path; //chronologie Chrome trace-event (NULL : pas de trace)
+    int aging_ms; //PRIORITY : attente en ms pour gagner un niveau de priorité (0 : aucun vieillissement)
+    int max_wait_ms; //attente au-delà de laquelle une tâche passe avant les autres (0 : aucune limite)
+    const char *shares; //FAIR : poids des types, "convert=1,compress=4" (NULL : poids égaux)
+} SchedulerConfig;
+
+//Nombre de workers par défaut (CPU en ligne)
+int scheduler_default_workers(void);
+
 //Ordonnanceur bloquant
-void run_scheduler(algo_t alg, Queue *q, int quantum);
+void run_scheduler(const SchedulerConfig *cfg, Queue *q);
 
 //Ordonnanceur dans un thread séparé non bloquant
-int start_scheduler_thread(algo_t alg, Queue *q, int quantum);
+int start_scheduler_thread(const SchedulerConfig *cfg, Queue *q);
+
+//Commandes sur l'ordonnanceur en cours, depuis ses hooks uniquement
+//Annuler une tâche : retirée de la file ou tuée si elle tourne (-1 si inconnue)
+int scheduler_cancel(unsigned long id);
+
+//Changer la priorité d'une tâche en file ou en cours (-1 si inconnue)
+int scheduler_set_priority(unsigned long id, int priority);
+
+//Tâches en cours puis contenu de la file
+void scheduler_fprint_status(FILE *f);
 
-#endif // SCHEDULER_H
\ No newline at end of file
+#endif // SCHEDULER_H
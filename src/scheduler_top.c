@@ -0,0 +1,166 @@
+// src/scheduler_top.c
+// Suivi en direct de l'ordonnanceur : scheduler-top [-d SECONDES] [-1]
+// Lit le tableau d'état partagé (status_board.h) ; l'ordonnanceur n'est pas sollicité.
+#include "status_board.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+
+// task.o n'est pas lié ici : même table, depuis task.h
+static const char *const type_names[TASK_TYPE_COUNT] = TASK_TYPE_NAMES;
+
+static const char *type_name(int type) {
+    return type >= 0 && type < TASK_TYPE_COUNT ? type_names[type] : "?";
+}
+
+static const char *algo_name(int algo) {
+    switch (algo) {
+        case 0:  return "FIFO";
+        case 1:  return "RR";
+        case 2:  return "Priority";
+        case 3:  return "MLFQ";
+        case 4:  return "SJF";
+        case 5:  return "EDF";
+        case 6:  return "FAIR";
+        default: return "?";
+    }
+}
+
+static void usage(void) {
+    fprintf(stderr,
+            "Usage : scheduler-top [-d SECONDES] [-1]\n"
+            "  -d  intervalle de rafraîchissement (1 s par défaut)\n"
+            "  -1  un seul affichage, sans effacer l'écran\n");
+}
+
+// Temps CPU (user + sys) d'un processus vivant, depuis /proc ; -1 si inconnu
+static int64_t proc_cpu_ns(int pid) {
+    char path[32], buf[1024];
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[n] = '\0';
+    // le nom du programme (2e champ) peut contenir des espaces : repartir de ')'
+    char *p = strrchr(buf, ')');
+    unsigned long long utime, stime;
+    if (!p || sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu",
+                     &utime, &stime) != 2) {
+        return -1;
+    }
+    long hz = sysconf(_SC_CLK_TCK);
+    return (int64_t)((utime + stime) * (1000000000ULL / (unsigned long long)(hz > 0 ? hz : 100)));
+}
+
+// "1h02m", "3m05s" ou "12.4s"
+static const char *fmt_duration(char *buf, size_t len, int64_t ns) {
+    if (ns < 0) {
+        snprintf(buf, len, "-");
+    } else if (ns >= 3600000000000LL) {
+        snprintf(buf, len, "%lldh%02lldm", (long long)(ns / 3600000000000LL),
+                 (long long)(ns / 60000000000LL % 60));
+    } else if (ns >= 60000000000LL) {
+        snprintf(buf, len, "%lldm%02llds", (long long)(ns / 60000000000LL),
+                 (long long)(ns / 1000000000LL % 60));
+    } else {
+        snprintf(buf, len, "%.1fs", ns / 1e9);
+    }
+    return buf;
+}
+
+static const char *fmt_status(char *buf, size_t len, int status) {
+    if (status < 0) snprintf(buf, len, "signal %d", -status);
+    else snprintf(buf, len, "exit %d", status);
+    return buf;
+}
+
+// Un affichage ; -1 si aucun ordonnanceur ne publie
+static int show(void) {
+    size_t size;
+    const StatusBoard *b = board_attach(&size);
+    if (!b) {
+        printf("Aucun ordonnanceur en cours (%s : %s)\n", STATUS_BOARD_NAME, strerror(errno));
+        return -1;
+    }
+    StatusBoard h;
+    board_read_header(b, &h);
+    if (h.owner == 0 || (kill(h.owner, 0) == -1 && errno == ESRCH)) {
+        printf("Ordonnanceur arrêté (pid %d)\n", (int)h.owner);
+        board_detach(b, size);
+        return -1;
+    }
+
+    int64_t now = board_now_ns();
+    char d1[16], d2[16], st[24];
+    printf("scheduler-top — pid %d, %s", (int)h.owner, algo_name(h.algo));
+    if (h.algo == 1 || h.algo == 3) printf(" (quantum %d ms)", (int)h.quantum_ms);
+    printf(", en marche depuis %s\n", fmt_duration(d1, sizeof(d1), now - h.boot_ns));
+    printf("Workers : %d/%d occupés   File : %llu   Terminées : %llu\n\n",
+           (int)h.running, (int)h.workers, (unsigned long long)h.queued,
+           (unsigned long long)h.finished);
+
+    printf("%4s %7s %7s %-9s %5s %9s %9s  %s\n",
+           "SLOT", "PID", "ID", "TYPE", "PRIO", "DEPUIS", "CPU", "PARAM");
+    for (int i = 0; i < h.workers; i++) {
+        BoardEntry e;
+        board_read_entry(&b->slots[i], &e);
+        if (e.pid == 0) {
+            printf("%4d %7s\n", i, "-");
+            continue;
+        }
+        printf("%4d %7d %7llu %-9s %5d %9s %9s  %s\n", i, (int)e.pid,
+               (unsigned long long)e.task_id, type_name(e.type), (int)e.priority,
+               fmt_duration(d1, sizeof(d1), now - e.start_ns),
+               fmt_duration(d2, sizeof(d2), proc_cpu_ns(e.pid)), e.param);
+    }
+
+    uint64_t n = h.finished < BOARD_RECENT ? h.finished : BOARD_RECENT;
+    if (n > 0) {
+        printf("\nDernières terminées :\n");
+        printf("%7s %7s %-9s %5s %9s %9s %-10s  %s\n",
+               "PID", "ID", "TYPE", "PRIO", "DUREE", "CPU", "STATUT", "PARAM");
+    }
+    for (uint64_t k = 0; k < n; k++) {
+        BoardEntry e;
+        board_read_entry(&b->recent[(h.finished - 1 - k) % BOARD_RECENT], &e);
+        printf("%7d %7llu %-9s %5d %9s %9s %-10s  %s\n", (int)e.pid,
+               (unsigned long long)e.task_id, type_name(e.type), (int)e.priority,
+               fmt_duration(d1, sizeof(d1), e.start_ns ? e.end_ns - e.start_ns : -1),
+               fmt_duration(d2, sizeof(d2), e.cpu_ns ? e.cpu_ns : -1),
+               fmt_status(st, sizeof(st), e.status), e.param);
+    }
+    board_detach(b, size);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    double delay = 1.0;
+    int once = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-1") == 0) {
+            once = 1;
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc && atof(argv[i + 1]) > 0) {
+            delay = atof(argv[++i]);
+        } else {
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+    if (once) return show() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    int tty = isatty(STDOUT_FILENO);
+    struct timespec ts = { (time_t)delay, (long)((delay - (time_t)delay) * 1e9) };
+    for (;;) {
+        // segment rouvert à chaque tour : suit un ordonnanceur relancé
+        if (tty) printf("\033[H\033[2J");
+        show();
+        fflush(stdout);
+        nanosleep(&ts, NULL);
+    }
+}
@@ -0,0 +1,354 @@
+// src/server.c
+#define _GNU_SOURCE
+#include "server.h"
+#include "proto.h"
+#include "batch.h"
+#include "event_loop.h"
+#include "log.h"
+#include "latency.h"
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#define READ_CHUNK (64 * 1024)
+#define READS_PER_EVENT 4   // au-delà, on laisse la main aux autres clients
+
+typedef struct Conn {
+    EventHandler ev;
+    Server *srv;
+    struct Conn *prev, *next;
+    unsigned char *in;       // octets reçus, trame en cours comprise
+    size_t in_len, in_cap;
+    unsigned char *out;      // réponses pas encore envoyées
+    size_t out_off, out_len, out_cap;
+    int want_out;            // EPOLLOUT demandé
+} Conn;
+
+struct Server {
+    EventHandler listen_ev;
+    char path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+    Queue *q;
+    EventLoop *loop;         // NULL hors de run_scheduler
+    Conn *conns;
+    SchedulerHooks hooks;
+};
+
+static int reserve(unsigned char **buf, size_t *cap, size_t need) {
+    if (need <= *cap) return 0;
+    size_t cap2 = *cap ? *cap : 4096;
+    while (cap2 < need) cap2 *= 2;
+    unsigned char *p = realloc(*buf, cap2);
+    if (!p) return -1;
+    *buf = p;
+    *cap = cap2;
+    return 0;
+}
+
+static void conn_close(Conn *c) {
+    Server *s = c->srv;
+    if (s->loop) event_loop_del(s->loop, &c->ev);
+    close(c->ev.fd);
+    if (c->prev) c->prev->next = c->next;
+    else s->conns = c->next;
+    if (c->next) c->next->prev = c->prev;
+    free(c->in);
+    free(c->out);
+    free(c);
+}
+
+// Ajoute une réponse (statut + charge) au tampon de sortie
+static int reply(Conn *c, uint8_t status, const void *payload, size_t len) {
+    size_t need = c->out_len + 5 + len;
+    if (reserve(&c->out, &c->out_cap, need) == -1) return -1;
+    unsigned char *p = c->out + c->out_len;
+    proto_put_u32(p, (uint32_t)(len + 1));
+    p[4] = status;
+    if (len > 0) memcpy(p + 5, payload, len);
+    c->out_len = need;
+    return 0;
+}
+
+static int reply_msg(Conn *c, uint8_t status, const char *msg) {
+    return reply(c, status, msg, strlen(msg));
+}
+
+// ====== Commandes ======
+static int do_submit(Conn *c, char *body, size_t len) {
+    Server *s = c->srv;
+    if (!queue_has_producers(s->q)) return reply_msg(c, ST_UNAVAILABLE, "arrêt en cours");
+    body[len] = '\0';
+    body[strcspn(body, "\r\n")] = '\0';
+    const char *err = NULL;
+    Task *t = batch_parse_line(body, &err);
+    if (!t) return reply_msg(c, ST_BAD_REQUEST, err);
+    // id puis, le cas échéant, l'avertissement d'admission
+    unsigned char resp[8 + 160];
+    proto_put_u64(resp, t->id);
+    size_t n = 8;
+    if (batch_admit(s->q, t, (char *)resp + 8, sizeof(resp) - 8) == 1) n += strlen((char *)resp + 8);
+    return reply(c, ST_OK, resp, n);
+}
+
+static int do_batch(Conn *c, char *body, size_t len) {
+    Server *s = c->srv;
+    if (!queue_has_producers(s->q)) return reply_msg(c, ST_UNAVAILABLE, "arrêt en cours");
+    body[len] = '\0';
+    uint32_t n = 0;
+    for (size_t i = 0; i < len; i++) n += body[i] == '\n';
+    if (len > 0 && body[len - 1] != '\n') n++;
+
+    unsigned char *ids = malloc(4 + (size_t)n * 8);
+    if (!ids) return reply_msg(c, ST_UNAVAILABLE, "plus de mémoire");
+    proto_put_u32(ids, n);
+    char *line = body;
+    for (uint32_t i = 0; i < n; i++) {
+        char *end = strchr(line, '\n');
+        if (end) *end = '\0';
+        size_t l = strlen(line);
+        if (l > 0 && line[l - 1] == '\r') line[--l] = '\0';
+        uint64_t id = 0;
+        if (l > 0 && line[0] != '#') {
+            const char *err = NULL;
+            Task *t = batch_parse_line(line, &err);
+            if (t) {
+                char warn[160]; // avertissement d'admission : journalisé seulement
+                id = t->id;
+                batch_admit(s->q, t, warn, sizeof(warn));
+            }
+        }
+        proto_put_u64(ids + 4 + (size_t)i * 8, id);
+        line = end ? end + 1 : line + l;
+    }
+    int res = reply(c, ST_OK, ids, 4 + (size_t)n * 8);
+    free(ids);
+    return res;
+}
+
+static int do_status(Conn *c) {
+    char *text = NULL;
+    size_t len = 0;
+    FILE *f = open_memstream(&text, &len);
+    if (!f) return reply_msg(c, ST_UNAVAILABLE, "plus de mémoire");
+    scheduler_fprint_status(f);
+    fclose(f);
+    int res = reply(c, ST_OK, text, len);
+    free(text);
+    return res;
+}
+
+static int do_latency(Conn *c) {
+    char *text = NULL;
+    size_t len = 0;
+    FILE *f = open_memstream(&text, &len);
+    if (!f) return reply_msg(c, ST_UNAVAILABLE, "plus de mémoire");
+    latency_write_json(f);
+    fclose(f);
+    int res = reply(c, ST_OK, text, len);
+    free(text);
+    return res;
+}
+
+static int handle(Conn *c, unsigned char *body, size_t len) {
+    uint8_t op = body[0];
+    body++;
+    len--;
+    switch (op) {
+        case OP_SUBMIT:
+            return do_submit(c, (char *)body, len);
+        case OP_BATCH:
+            return do_batch(c, (char *)body, len);
+        case OP_CANCEL:
+            if (len != 8) break;
+            return reply(c, scheduler_cancel(proto_get_u64(body)) == 0 ? ST_OK : ST_NOT_FOUND, NULL, 0);
+        case OP_PRIORITY:
+            if (len != 12) break;
+            return reply(c, scheduler_set_priority(proto_get_u64(body), (int32_t)proto_get_u32(body + 8)) == 0
+                         ? ST_OK : ST_NOT_FOUND, NULL, 0);
+        case OP_STATUS:
+            return do_status(c);
+        case OP_LATENCY:
+            return do_latency(c);
+    }
+    return reply_msg(c, ST_BAD_REQUEST, "requête inconnue");
+}
+
+// Envoie ce qui peut l'être ; EPOLLOUT seulement tant qu'il reste des octets
+static int conn_flush(Conn *c) {
+    while (c->out_off < c->out_len) {
+        ssize_t n = send(c->ev.fd, c->out + c->out_off, c->out_len - c->out_off, MSG_NOSIGNAL);
+        if (n == -1 && errno == EINTR) continue;
+        if (n == -1 && errno == EAGAIN) break;
+        if (n == -1) return -1;
+        c->out_off += (size_t)n;
+    }
+    if (c->out_off == c->out_len) c->out_off = c->out_len = 0;
+    int want = c->out_len > 0;
+    if (want != c->want_out) {
+        c->want_out = want;
+        event_loop_mod(c->srv->loop, &c->ev, EPOLLIN | (want ? EPOLLOUT : 0));
+    }
+    return 0;
+}
+
+static void on_conn(void *arg, uint32_t events) {
+    Conn *c = arg;
+    int eof = 0;
+    if (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+        for (int r = 0; r < READS_PER_EVENT; r++) {
+            // +1 : place pour terminer une ligne par '\0' dans handle
+            if (reserve(&c->in, &c->in_cap, c->in_len + READ_CHUNK + 1) == -1) {
+                conn_close(c);
+                return;
+            }
+            ssize_t n = read(c->ev.fd, c->in + c->in_len, READ_CHUNK);
+            if (n == -1 && errno == EINTR) continue;
+            if (n == -1 && errno == EAGAIN) break;
+            if (n <= 0) {
+                eof = 1;
+                break;
+            }
+            c->in_len += (size_t)n;
+        }
+    }
+
+    // Toutes les trames complètes, dans l'ordre
+    size_t off = 0;
+    while (c->in_len - off >= 4) {
+        uint32_t size = proto_get_u32(c->in + off);
+        if (size == 0 || size > PROTO_MAX_FRAME) {
+            conn_close(c);
+            return;
+        }
+        if (c->in_len - off - 4 < size) {
+            if (reserve(&c->in, &c->in_cap, off + 4 + size + 1) == -1) {
+                conn_close(c);
+                return;
+            }
+            break;
+        }
+        // l'octet suivant la trame peut être écrasé : il est recopié plus bas
+        unsigned char saved = off + 4 + size < c->in_len ? c->in[off + 4 + size] : 0;
+        int res = handle(c, c->in + off + 4, size);
+        if (off + 4 + size < c->in_len) c->in[off + 4 + size] = saved;
+        if (res == -1) {
+            conn_close(c);
+            return;
+        }
+        off += 4 + (size_t)size;
+    }
+    if (off > 0) {
+        memmove(c->in, c->in + off, c->in_len - off);
+        c->in_len -= off;
+    }
+
+    if (conn_flush(c) == -1 || eof) conn_close(c);
+}
+
+static void on_accept(void *arg, uint32_t events) {
+    (void)events;
+    Server *s = arg;
+    for (;;) {
+        int fd = accept4(s->listen_ev.fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN) log_msg("[Daemon][ERREUR] accept: %s", strerror(errno));
+            return;
+        }
+        Conn *c = calloc(1, sizeof(Conn));
+        if (!c) {
+            close(fd);
+            continue;
+        }
+        c->ev.fd = fd;
+        c->ev.cb = on_conn;
+        c->ev.arg = c;
+        c->srv = s;
+        if (event_loop_add(s->loop, &c->ev, EPOLLIN) == -1) {
+            close(fd);
+            free(c);
+            continue;
+        }
+        c->next = s->conns;
+        if (s->conns) s->conns->prev = c;
+        s->conns = c;
+    }
+}
+
+// ====== Hooks de l'ordonnanceur ======
+static int server_attach(void *arg, EventLoop *loop) {
+    Server *s = arg;
+    s->loop = loop;
+    return event_loop_add(loop, &s->listen_ev, EPOLLIN);
+}
+
+static void server_detach(void *arg, EventLoop *loop) {
+    Server *s = arg;
+    while (s->conns) conn_close(s->conns);
+    event_loop_del(loop, &s->listen_ev);
+    s->loop = NULL;
+}
+
+Server *server_open(const char *path, Queue *q) {
+    Server *s = calloc(1, sizeof(Server));
+    if (!s) return NULL;
+    if (strlen(path) >= sizeof(s->path)) {
+        free(s);
+        errno = ENAMETOOLONG;
+        return NULL;
+    }
+    strcpy(s->path, path);
+    s->q = q;
+    s->hooks.attach = server_attach;
+    s->hooks.detach = server_detach;
+    s->hooks.arg = s;
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    s->listen_ev.fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    s->listen_ev.cb = on_accept;
+    s->listen_ev.arg = s;
+    if (s->listen_ev.fd == -1) {
+        free(s);
+        return NULL;
+    }
+    // Un socket restant d'un démon arrêté brutalement : personne n'y répond
+    if (connect(s->listen_ev.fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+        close(s->listen_ev.fd);
+        free(s);
+        errno = EADDRINUSE;
+        return NULL;
+    }
+    unlink(path);
+    close(s->listen_ev.fd);
+    s->listen_ev.fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (s->listen_ev.fd == -1
+        || bind(s->listen_ev.fd, (struct sockaddr *)&addr, sizeof(addr)) == -1
+        || listen(s->listen_ev.fd, SOMAXCONN) == -1) {
+        int err = errno;
+        if (s->listen_ev.fd >= 0) close(s->listen_ev.fd);
+        free(s);
+        errno = err;
+        return NULL;
+    }
+    return s;
+}
+
+const SchedulerHooks *server_hooks(Server *s) {
+    return &s->hooks;
+}
+
+void server_close(Server *s) {
+    if (!s) return;
+    if (s->loop) server_detach(s, s->loop);
+    close(s->listen_ev.fd);
+    unlink(s->path);
+    free(s);
+}
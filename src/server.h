@@ -0,0 +1,20 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "queue.h"
+#include "scheduler.h"
+
+//Serveur de commandes du mode démon : socket UNIX (protocole de proto.h)
+//servi par la boucle d'événements de l'ordonnanceur, sans thread à lui
+typedef struct Server Server;
+
+//Crée le socket d'écoute (un socket abandonné au même chemin est remplacé)
+Server *server_open(const char *path, Queue *q);
+
+//Hooks à placer dans SchedulerConfig pour brancher le serveur sur la boucle
+const SchedulerHooks *server_hooks(Server *s);
+
+//Ferme les connexions et le socket, supprime le fichier
+void server_close(Server *s);
+
+#endif // SERVER_H
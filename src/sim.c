@@ -0,0 +1,419 @@
+// src/sim.c
+#include "sim.h"
+#include "policy.h"
+#include "heap.h"
+#include "latency.h"    // Histogram
+#include "estimate.h"
+#include "fair.h"
+#include "event_loop.h" // monotonic_ns
+
+#include <stdio.h>
+#include <stddef.h>     // offsetof
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>       // isfinite
+
+#define SIM_EPOCH_NS 1000000000LL // origine de l'horloge virtuelle : 0 reste « pas encore »
+#define SIM_SLAB 4096             // tâches par bloc alloué
+#define SIM_METRICS (LAT_TURNAROUND + 1)
+
+static const char *metric_names[SIM_METRICS] = { "attente", "reponse", "rotation" };
+
+// Ligne de la trace
+typedef struct {
+    long long at_ns;
+    long long run_ns;
+    long long deadline_ns; // après l'arrivée (0 : aucune)
+    unsigned long line; // départage les arrivées simultanées
+    int priority;
+    task_type_t type;
+} SimArrival;
+
+// Tâche simulée : la politique ne voit que le Task
+typedef struct {
+    Task task;
+    long long left_ns; // temps d'exécution restant
+} SimTask;
+
+typedef struct SimChunk {
+    struct SimChunk *next;
+    SimTask items[SIM_SLAB];
+} SimChunk;
+
+typedef struct {
+    SimTask *st;        // tâche en cours (NULL : libre)
+    long long since_ns; // début du passage
+    long long until_ns; // fin du passage ou de la tâche
+} SimWorker;
+
+typedef struct {
+    Policy pol;
+    RuntimeModel model;       // SJF : appris au fil de la simulation, jamais enregistré
+    TaskHeap ready;
+    TaskHeap waiting;         // par ancienneté, si max_wait_ns > 0 (comme la file)
+    long long max_wait_ns;
+    FairShare fair;           // FAIR : classes et temps virtuels (comme la file)
+    SimWorker *workers;
+    int n;
+    int running;
+    unsigned long seq;
+    SimChunk *chunks;
+    SimTask *free_list;       // chaînées par task.next
+    int chunk_used;           // places prises dans le bloc courant
+    unsigned long long done[TASK_TYPE_COUNT + 1];
+    Histogram *h[TASK_TYPE_COUNT + 1][SIM_METRICS]; // dernier rang : tous types
+    unsigned long long preemptions;
+    unsigned long long deadlines, missed; // tâches à échéance, échéances manquées
+    long long late_ns, late_max_ns;       // retards cumulé et maximal
+    long long busy_ns;        // somme des passages sur tous les workers
+    long long end_ns;         // fin de la dernière tâche (horloge virtuelle)
+} Sim;
+
+// ====== Lecture de la trace ======
+static int parse_ms(const char *s, long long *ns) {
+    char *end;
+    double v = strtod(s, &end);
+    if (end == s || *end != '\0' || !isfinite(v) || v < 0 || v > 1e12) return -1;
+    *ns = (long long)(v * 1e6 + 0.5);
+    return 0;
+}
+
+static const char *parse_line(char *line, SimArrival *a) {
+    char *field[5], *save;
+    int n = 0;
+    for (char *f = strtok_r(line, " \t", &save); f && n < 5; f = strtok_r(NULL, " \t", &save)) {
+        field[n++] = f;
+    }
+    if (n < 4) return "4 champs attendus : arrivée type priorité durée [échéance]";
+    char *end;
+    long prio = strtol(field[2], &end, 10);
+    if (parse_ms(field[0], &a->at_ns) == -1) return "arrivée invalide";
+    if (task_parse_type(field[1], strlen(field[1]), &a->type) == -1) return "type de tâche inconnu";
+    if (end == field[2] || *end != '\0' || prio < -1000000 || prio > 1000000) return "priorité invalide";
+    if (parse_ms(field[3], &a->run_ns) == -1) return "durée invalide";
+    a->deadline_ns = 0;
+    if (n == 5 && (parse_ms(field[4], &a->deadline_ns) == -1 || a->deadline_ns == 0)) {
+        return "échéance invalide";
+    }
+    a->priority = (int)prio;
+    return NULL;
+}
+
+static int cmp_arrival_line(const void *pa, const void *pb) {
+    const SimArrival *a = pa, *b = pb;
+    if (a->at_ns != b->at_ns) return a->at_ns < b->at_ns ? -1 : 1;
+    return (a->line > b->line) - (a->line < b->line);
+}
+
+// Toute la trace en mémoire (32 octets par tâche), triée par arrivée
+static SimArrival *read_trace(FILE *in, const char *name, size_t *count) {
+    SimArrival *arr = NULL;
+    size_t n = 0, cap = 0;
+    int sorted = 1, errors = 0;
+    char *line = NULL;
+    size_t len = 0;
+    ssize_t got;
+    unsigned long lineno = 0;
+    while ((got = getline(&line, &len, in)) != -1) {
+        lineno++;
+        while (got > 0 && (line[got - 1] == '\n' || line[got - 1] == '\r')) line[--got] = '\0';
+        if (got == 0 || line[0] == '#') continue;
+        if (n == cap) {
+            size_t ncap = cap ? cap * 2 : 4096;
+            SimArrival *grown = realloc(arr, ncap * sizeof(SimArrival));
+            if (!grown) {
+                perror("[Sim] trace");
+                errors++;
+                break;
+            }
+            arr = grown;
+            cap = ncap;
+        }
+        const char *err = parse_line(line, &arr[n]);
+        if (err) {
+            fprintf(stderr, "[Sim] %s:%lu: %s\n", name, lineno, err);
+            errors++;
+            continue;
+        }
+        arr[n].line = lineno;
+        if (n > 0 && arr[n].at_ns < arr[n - 1].at_ns) sorted = 0;
+        n++;
+    }
+    if (ferror(in)) {
+        perror("[Sim] lecture de la trace");
+        errors++;
+    }
+    free(line);
+    if (errors > 0 || n == 0) {
+        if (errors == 0) fprintf(stderr, "[Sim] %s : aucune tâche\n", name);
+        free(arr);
+        return NULL;
+    }
+    if (!sorted) qsort(arr, n, sizeof(SimArrival), cmp_arrival_line);
+    *count = n;
+    return arr;
+}
+
+// ====== Tâches simulées ======
+static SimTask *sim_task_new(Sim *s, const SimArrival *a) {
+    SimTask *st = s->free_list;
+    if (st) {
+        s->free_list = (SimTask *)st->task.next;
+    } else {
+        if (!s->chunks || s->chunk_used == SIM_SLAB) {
+            SimChunk *c = malloc(sizeof(SimChunk));
+            if (!c) return NULL;
+            c->next = s->chunks;
+            s->chunks = c;
+            s->chunk_used = 0;
+        }
+        st = &s->chunks->items[s->chunk_used++];
+    }
+    memset(&st->task, 0, sizeof(Task));
+    st->task.id = a->line;
+    st->task.type = a->type;
+    st->task.priority = a->priority;
+    if (a->deadline_ns) st->task.deadline_ns = SIM_EPOCH_NS + a->at_ns + a->deadline_ns;
+    st->task.state = READY;
+    st->task.heap_idx = -1;
+    st->task.wait_idx = -1;
+    st->task.class_idx = -1;
+    st->left_ns = a->run_ns;
+    return st;
+}
+
+static void sim_task_free(Sim *s, SimTask *st) {
+    st->task.next = (Task *)s->free_list;
+    s->free_list = st;
+}
+
+static void record(Sim *s, int row, int m, long long ns) {
+    if (!s->h[row][m] && !(s->h[row][m] = calloc(1, sizeof(Histogram)))) return;
+    hist_record(s->h[row][m], (unsigned long long)(ns / 1000));
+}
+
+static void sim_finish(Sim *s, SimTask *st, long long now) {
+    Task *t = &st->task;
+    t->end_ns = now;
+    t->state = TERMINATED;
+    estimate_model_learn(&s->model, t->type, t->work, t->end_ns - t->enqueue_ns - t->wait_ns);
+    if (t->deadline_ns) {
+        s->deadlines++;
+        if (now > t->deadline_ns) {
+            long long late = now - t->deadline_ns;
+            s->missed++;
+            s->late_ns += late;
+            if (late > s->late_max_ns) s->late_max_ns = late;
+        }
+    }
+    for (int row = 0; row < 2; row++) {
+        int r = row ? TASK_TYPE_COUNT : (int)t->type;
+        s->done[r]++;
+        record(s, r, LAT_WAITING, t->wait_ns);
+        record(s, r, LAT_RESPONSE, t->start_ns - t->enqueue_ns);
+        record(s, r, LAT_TURNAROUND, t->end_ns - t->enqueue_ns);
+    }
+    sim_task_free(s, st);
+}
+
+// Comme enqueue() : nouveau numéro d'arrivée, horodatage de (re)mise en file
+static int sim_enqueue(Sim *s, SimTask *st, long long now) {
+    Task *t = &st->task;
+    if (!t->enqueue_ns) t->enqueue_ns = now;
+    // la trace ne donne pas la taille des entrées : estimation par type seul
+    if (!t->est_ns) t->est_ns = estimate_model_runtime(&s->model, t->type, t->work);
+    t->ready_ns = now;
+    t->state = READY;
+    t->seq = s->seq++;
+    if (heap_push(&s->ready, t) == -1) return -1;
+    if (s->max_wait_ns > 0 && heap_push(&s->waiting, t) == -1) return -1;
+    if (s->pol.alg == ALG_FAIR && fair_push(&s->fair, t) == -1) return -1;
+    return 0;
+}
+
+// Comme dequeue_batch() : la plus ancienne si elle a dépassé l'attente maximale,
+// sinon la première selon l'ordre de la politique
+static Task *sim_next(Sim *s, long long now) {
+    Task *t = heap_peek(&s->waiting);
+    if (t && s->max_wait_ns > 0 && now - t->ready_ns >= s->max_wait_ns) heap_remove(&s->ready, t);
+    else if (s->pol.alg == ALG_FAIR && (t = fair_peek(&s->fair))) heap_remove(&s->ready, t);
+    else t = heap_pop(&s->ready);
+    heap_remove(&s->waiting, t);
+    if (s->pol.alg == ALG_FAIR) fair_take(&s->fair, t);
+    return t;
+}
+
+// Passage de st sur w à partir de now : jusqu'à la fin du quantum ou de la tâche
+static void sim_slice(Sim *s, SimWorker *w, SimTask *st, long long now) {
+    long long slice = policy_slice_ms(&s->pol, &st->task) * 1000000LL;
+    w->st = st;
+    w->since_ns = now;
+    w->until_ns = now + (slice > 0 && slice < st->left_ns ? slice : st->left_ns);
+}
+
+// ====== Boucle à événements discrets ======
+static int simulate(Sim *s, const SimArrival *arr, size_t n) {
+    size_t next = 0;
+    long long now = SIM_EPOCH_NS;
+    long long boost = policy_boost_ms(&s->pol) * 1000000LL;
+    long long next_boost = boost > 0 ? SIM_EPOCH_NS + boost : LLONG_MAX;
+    while (next < n || s->running > 0) {
+        // Prochain événement : arrivée, fin de passage ou remontée, le plus proche
+        long long ev = next < n ? SIM_EPOCH_NS + arr[next].at_ns : LLONG_MAX;
+        for (int i = 0; i < s->n; i++) {
+            if (s->workers[i].st && s->workers[i].until_ns < ev) ev = s->workers[i].until_ns;
+        }
+        if (s->running > 0 && next_boost < ev) ev = next_boost;
+        now = ev;
+
+        if (now >= next_boost) {
+            // comme on_boost() : tâches en cours et en file, puis la file réorganisée
+            for (int i = 0; i < s->n; i++) {
+                if (s->workers[i].st) policy_boost(&s->pol, &s->workers[i].st->task);
+            }
+            for (int i = 0; i < s->ready.size; i++) policy_boost(&s->pol, s->ready.items[i]);
+            heap_set_cmp(&s->ready, s->ready.cmp);
+            // périodes écoulées à vide : rien à remonter
+            next_boost += ((now - next_boost) / boost + 1) * boost;
+        }
+
+        for (; next < n && SIM_EPOCH_NS + arr[next].at_ns <= now; next++) {
+            SimTask *st = sim_task_new(s, &arr[next]);
+            if (!st || sim_enqueue(s, st, now) == -1) return -1;
+        }
+
+        for (int i = 0; i < s->n; i++) {
+            SimWorker *w = &s->workers[i];
+            SimTask *st = w->st;
+            if (!st || w->until_ns > now) continue;
+            st->left_ns -= now - w->since_ns;
+            s->busy_ns += now - w->since_ns;
+            // la durée de la trace tient lieu de temps CPU
+            task_type_t type = st->task.type;
+            if (st->left_ns <= 0) {
+                w->st = NULL;
+                s->running--;
+                if (s->pol.alg == ALG_FAIR) fair_account(&s->fair, type, now - w->since_ns, 0);
+                sim_finish(s, st, now);
+            } else if (policy_expire(&s->pol, &st->task, s->pol.alg == ALG_FAIR
+                                     ? fair_should_preempt(&s->fair, type, now - w->since_ns) : s->ready.size > 0)) {
+                w->st = NULL;
+                s->running--;
+                st->task.preemptions++;
+                s->preemptions++;
+                if (s->pol.alg == ALG_FAIR) fair_account(&s->fair, type, now - w->since_ns, 0);
+                if (sim_enqueue(s, st, now) == -1) return -1;
+            } else {
+                if (s->pol.alg == ALG_FAIR) fair_account(&s->fair, type, now - w->since_ns, 1);
+                sim_slice(s, w, st, now);
+            }
+        }
+
+        // Remplir les workers libres dans l'ordre de la politique
+        for (int i = 0; i < s->n && s->ready.size > 0; i++) {
+            if (s->workers[i].st) continue;
+            Task *t = sim_next(s, now);
+            t->wait_ns += now - t->ready_ns;
+            if (!t->start_ns) t->start_ns = now;
+            t->state = RUNNING;
+            sim_slice(s, &s->workers[i], (SimTask *)t, now);
+            s->running++;
+        }
+    }
+    s->end_ns = now;
+    return 0;
+}
+
+// ====== Rapport ======
+static void print_row(FILE *out, const char *label, const char *metric, const Histogram *h) {
+    fprintf(out, "%-12s %-9s %12.1f %12.1f %12.1f %12.1f %12.1f\n", label, metric,
+            (double)h->sum / (double)h->count / 1000.0, hist_percentile(h, 50) / 1000.0,
+            hist_percentile(h, 90) / 1000.0, hist_percentile(h, 99) / 1000.0, h->max / 1000.0);
+}
+
+static void report(const Sim *s, const SchedulerConfig *cfg, const char *name, size_t n,
+                   double elapsed, FILE *out) {
+    double span = (double)(s->end_ns - SIM_EPOCH_NS);
+    static const char *names[ALG_COUNT] = { "FIFO", "Round Robin", "Priority", "MLFQ", "SJF", "EDF", "FAIR" };
+    fprintf(out, "===== Simulation %s", names[cfg->alg]);
+    if (cfg->alg == ALG_RR) fprintf(out, " (quantum %ld ms)", s->pol.quantum_ms);
+    if (cfg->alg == ALG_MLFQ) {
+        fprintf(out, " (%d niveaux, quantum %ld ms au niveau 0, remontée toutes les %ld ms)",
+                MLFQ_LEVELS, s->pol.quantum_ms, policy_boost_ms(&s->pol));
+    }
+    if (cfg->alg == ALG_SJF) fprintf(out, " (durées estimées par type, apprises en cours de route)");
+    if (cfg->alg == ALG_FAIR) {
+        fprintf(out, " (quantum %ld ms, poids %s)", s->pol.quantum_ms, cfg->shares ? cfg->shares : "égaux");
+    }
+    if (cfg->alg == ALG_PRIORITY && cfg->aging_ms > 0) {
+        fprintf(out, " (+1 niveau toutes les %d ms d'attente)", cfg->aging_ms);
+    }
+    if (cfg->max_wait_ms > 0) fprintf(out, ", attente maximale %d ms", cfg->max_wait_ms);
+    fprintf(out, ", %d worker(s) : %zu tâches de %s =====\n", s->n, n, name);
+    fprintf(out, "Durée simulée %.3f s, workers occupés à %.1f %%, %llu préemption(s), "
+                 "calculée en %.3f s\n", span / 1e9,
+            span > 0 ? 100.0 * (double)s->busy_ns / (span * s->n) : 0.0, s->preemptions, elapsed);
+    if (s->deadlines > 0) {
+        fprintf(out, "Échéances manquées : %llu sur %llu (%.1f %%), retard moyen %.1f ms, max %.1f ms\n",
+                s->missed, s->deadlines, 100.0 * (double)s->missed / (double)s->deadlines,
+                s->missed ? s->late_ns / 1e6 / (double)s->missed : 0.0, s->late_max_ns / 1e6);
+    }
+    fprintf(out, "%-12s %-9s %12s %12s %12s %12s %12s\n", "Type", "(ms)", "moyenne", "p50", "p90",
+            "p99", "max");
+    // « Tout » d'abord, puis chaque type
+    for (int k = 0; k <= TASK_TYPE_COUNT; k++) {
+        int r = k == 0 ? TASK_TYPE_COUNT : k - 1;
+        if (s->done[r] == 0) continue;
+        for (int m = 0; m < SIM_METRICS; m++) {
+            if (!s->h[r][m]) continue;
+            print_row(out, m > 0 ? "" : r == TASK_TYPE_COUNT ? "Tout" : task_type_labels[r],
+                      metric_names[m], s->h[r][m]);
+        }
+    }
+}
+
+int sim_run(const SchedulerConfig *cfg, FILE *in, const char *name, FILE *out) {
+    size_t n;
+    SimArrival *arr = read_trace(in, name, &n);
+    if (!arr) return -1;
+
+    Sim s;
+    memset(&s, 0, sizeof(s));
+    policy_init(&s.pol, cfg->alg, cfg->quantum_ms);
+    estimate_model_init(&s.model);
+    queue_set_aging((long long)cfg->aging_ms * 1000000LL);
+    heap_init(&s.ready, queue_order_cmp(policy_queue_order(cfg->alg)));
+    heap_init_at(&s.waiting, queue_wait_cmp(), offsetof(Task, wait_idx));
+    s.max_wait_ns = (long long)cfg->max_wait_ms * 1000000LL;
+    unsigned weights[TASK_TYPE_COUNT];
+    fair_init(&s.fair);
+    fair_configure(&s.fair, fair_parse_weights(cfg->shares, weights) == 0 ? weights : NULL,
+                   s.pol.quantum_ms * 1000000LL);
+    s.n = cfg->workers > 0 ? cfg->workers : scheduler_default_workers();
+    s.workers = calloc((size_t)s.n, sizeof(SimWorker));
+
+    long long t0 = monotonic_ns();
+    int res = s.workers ? simulate(&s, arr, n) : -1;
+    double elapsed = (monotonic_ns() - t0) / 1e9;
+    if (res == -1) {
+        fprintf(stderr, "[Sim] mémoire insuffisante\n");
+    } else {
+        report(&s, cfg, name, n, elapsed, out);
+    }
+
+    for (int r = 0; r <= TASK_TYPE_COUNT; r++) {
+        for (int m = 0; m < SIM_METRICS; m++) free(s.h[r][m]);
+    }
+    while (s.chunks) {
+        SimChunk *c = s.chunks;
+        s.chunks = c->next;
+        free(c);
+    }
+    heap_destroy(&s.ready);
+    heap_destroy(&s.waiting);
+    fair_destroy(&s.fair);
+    free(s.workers);
+    free(arr);
+    return res;
+}
@@ -0,0 +1,28 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdio.h>
+#include "scheduler.h"
+
+//Simulation à événements discrets : une trace de tâches passe par la même
+//politique que l'ordonnanceur réel (policy.c) sur une horloge virtuelle, sans
+//créer de processus, pour régler algorithme, quantum et nombre de workers hors
+//production. Une tâche par ligne, champs séparés par des tabulations ou des espaces :
+//  arrivée(ms)  type  priorité  durée(ms)  [échéance(ms)]
+//type comme dans un manifeste (batch.h) ; durée = temps d'exécution mesuré
+//(colonne « reel » du bilan de consommation). Les lignes vides et celles
+//commençant par '#' sont ignorées ; les arrivées peuvent être dans le désordre.
+//L'échéance facultative compte depuis l'arrivée ; le rapport donne alors les
+//échéances manquées, quel que soit l'algorithme.
+//En SJF, la durée n'est pas connue d'avance : chaque tâche est estimée par la
+//moyenne des tâches de son type déjà terminées dans la simulation (estimate.h).
+//En FAIR, la durée d'exécution compte comme temps CPU consommé (fair.h).
+
+//Simule cfg->alg avec cfg->workers workers, cfg->quantum_ms, cfg->aging_ms,
+//cfg->max_wait_ms et cfg->shares sur la trace in
+//(lignes invalides signalées name:ligne sur stderr) puis écrit dans out les
+//statistiques d'attente, de réponse et de rotation par type de tâche.
+//Retourne 0, ou -1 si la trace est illisible ou invalide.
+int sim_run(const SchedulerConfig *cfg, FILE *in, const char *name, FILE *out);
+
+#endif // SIM_H
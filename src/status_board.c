@@ -0,0 +1,189 @@
+// src/status_board.c
+#include "status_board.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+#define READ_RETRIES 1000 // écrivain mort au milieu d'une écriture : copie telle quelle
+
+static ino_t board_ino; // segment créé par ce processus (board_destroy)
+static size_t board_len;
+
+size_t board_size(int workers) {
+    return sizeof(StatusBoard) + (size_t)workers * sizeof(BoardEntry);
+}
+
+int64_t board_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// ====== Seqlock, côté écrivain (un seul : le thread ordonnanceur) ======
+static void write_begin(uint32_t *seq) {
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE); // seq impair visible avant les données
+}
+
+static void write_end(uint32_t *seq) {
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELEASE);
+}
+
+StatusBoard *board_create(int workers, int algo, int quantum_ms) {
+    size_t len = board_size(workers);
+    // Segment neuf : un lecteur encore attaché à l'ancien voit son owner passer à 0
+    shm_unlink(STATUS_BOARD_NAME);
+    int fd = shm_open(STATUS_BOARD_NAME, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd == -1) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) == -1 || ftruncate(fd, (off_t)len) == -1) {
+        int err = errno;
+        close(fd);
+        shm_unlink(STATUS_BOARD_NAME);
+        errno = err;
+        return NULL;
+    }
+    StatusBoard *b = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (b == MAP_FAILED) {
+        shm_unlink(STATUS_BOARD_NAME);
+        return NULL;
+    }
+    board_ino = st.st_ino;
+    board_len = len;
+
+    // ftruncate a tout mis à zéro
+    b->version = STATUS_BOARD_VERSION;
+    b->owner = (int32_t)getpid();
+    b->algo = algo;
+    b->quantum_ms = quantum_ms;
+    b->workers = workers;
+    b->boot_ns = board_now_ns();
+    __atomic_store_n(&b->magic, STATUS_BOARD_MAGIC, __ATOMIC_RELEASE);
+    return b;
+}
+
+void board_destroy(StatusBoard *b) {
+    if (!b) return;
+    write_begin(&b->seq);
+    b->owner = 0;
+    b->running = 0;
+    write_end(&b->seq);
+    munmap(b, board_len);
+    // un autre ordonnanceur a pu remplacer le segment entre-temps
+    int fd = shm_open(STATUS_BOARD_NAME, O_RDONLY, 0);
+    if (fd == -1) return;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_ino == board_ino) shm_unlink(STATUS_BOARD_NAME);
+    close(fd);
+}
+
+static void fill_entry(BoardEntry *e, const Task *t) {
+    e->pid = t->pid;
+    e->task_id = t->id;
+    e->type = t->type;
+    e->state = t->state;
+    e->priority = t->priority;
+    e->start_ns = t->start_ns;
+    if (t->param1) {
+        strncpy(e->param, t->param1, BOARD_PARAM_LEN - 1);
+        e->param[BOARD_PARAM_LEN - 1] = '\0';
+    } else {
+        e->param[0] = '\0';
+    }
+}
+
+void board_slot_run(StatusBoard *b, int slot, const Task *t) {
+    if (!b) return;
+    BoardEntry *e = &b->slots[slot];
+    write_begin(&e->seq);
+    fill_entry(e, t);
+    e->status = 0;
+    e->end_ns = 0;
+    e->cpu_ns = 0;
+    write_end(&e->seq);
+}
+
+void board_slot_free(StatusBoard *b, int slot) {
+    if (!b) return;
+    BoardEntry *e = &b->slots[slot];
+    write_begin(&e->seq);
+    e->pid = 0;
+    e->task_id = 0;
+    write_end(&e->seq);
+}
+
+void board_task_done(StatusBoard *b, const Task *t, int status, int64_t cpu_ns) {
+    if (!b) return;
+    BoardEntry *e = &b->recent[b->finished % BOARD_RECENT];
+    write_begin(&e->seq);
+    fill_entry(e, t);
+    e->status = status;
+    e->end_ns = board_now_ns();
+    e->cpu_ns = cpu_ns;
+    write_end(&e->seq);
+    write_begin(&b->seq);
+    b->finished++;
+    write_end(&b->seq);
+}
+
+void board_update(StatusBoard *b, int running, unsigned long queued) {
+    if (!b || (b->running == running && b->queued == queued)) return;
+    write_begin(&b->seq);
+    b->running = running;
+    b->queued = queued;
+    write_end(&b->seq);
+}
+
+// ====== Côté lecteur ======
+const StatusBoard *board_attach(size_t *size) {
+    int fd = shm_open(STATUS_BOARD_NAME, O_RDONLY, 0);
+    if (fd == -1) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(StatusBoard)) {
+        close(fd);
+        errno = ENOENT; // segment en cours de création
+        return NULL;
+    }
+    const StatusBoard *b = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (b == MAP_FAILED) return NULL;
+    if (__atomic_load_n(&b->magic, __ATOMIC_ACQUIRE) != STATUS_BOARD_MAGIC
+        || b->version != STATUS_BOARD_VERSION
+        || board_size(b->workers) > (size_t)st.st_size) {
+        munmap((void *)b, (size_t)st.st_size);
+        errno = EPROTO;
+        return NULL;
+    }
+    *size = (size_t)st.st_size;
+    return b;
+}
+
+void board_detach(const StatusBoard *b, size_t size) {
+    if (b) munmap((void *)b, size);
+}
+
+// Copie len octets protégés par seq, recommencée si une écriture l'a croisée
+static void read_copy(const uint32_t *seq, void *dst, const void *src, size_t len) {
+    for (int i = 0; i < READ_RETRIES; i++) {
+        uint32_t s1 = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+        if (s1 & 1) continue;
+        memcpy(dst, src, len);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(seq, __ATOMIC_RELAXED) == s1) return;
+    }
+    memcpy(dst, src, len);
+}
+
+void board_read_header(const StatusBoard *b, StatusBoard *out) {
+    read_copy(&b->seq, out, b, offsetof(StatusBoard, recent));
+}
+
+void board_read_entry(const BoardEntry *e, BoardEntry *out) {
+    read_copy(&e->seq, out, e, sizeof(BoardEntry));
+}
@@ -0,0 +1,85 @@
+#ifndef STATUS_BOARD_H
+#define STATUS_BOARD_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "task.h"
+
+//Tableau d'état partagé : l'ordonnanceur publie l'état de ses workers dans un
+//segment de mémoire partagée (shm_open), lu par scheduler-top. Chaque entrée
+//est protégée par un seqlock : l'ordonnanceur (seul écrivain) n'y fait que des
+//écritures en mémoire, sans appel système ni verrou ; le lecteur recommence sa
+//copie si une écriture l'a croisée.
+
+#define STATUS_BOARD_NAME "/scheduler-board"
+#define STATUS_BOARD_MAGIC 0x42445353u //"SSDB"
+#define STATUS_BOARD_VERSION 2
+#define BOARD_PARAM_LEN 64 //début de param1 (tronqué)
+#define BOARD_RECENT 16 //dernières tâches terminées gardées
+
+//Une tâche sur un worker, ou une tâche terminée
+typedef struct {
+    uint32_t seq; //seqlock : impair pendant une écriture
+    int32_t pid; //0 : worker libre
+    uint64_t task_id;
+    int32_t type; //task_type_t
+    int32_t state; //task_state_t
+    int32_t priority;
+    int32_t status; //tâche terminée : code de sortie, ou -signal
+    int64_t start_ns; //premier lancement (CLOCK_MONOTONIC)
+    int64_t end_ns; //fin (tâche terminée)
+    int64_t cpu_ns; //temps CPU user + sys connu de l'ordonnanceur (0 : inconnu)
+    char param[BOARD_PARAM_LEN];
+} BoardEntry;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t seq; //seqlock des compteurs qui suivent
+    int32_t owner; //pid de l'ordonnanceur (0 : arrêté)
+    int32_t algo; //algo_t
+    int32_t quantum_ms; //RR, MLFQ (niveau 0)
+    int32_t workers; //entrées dans slots[]
+    int32_t running;
+    uint64_t queued; //tâches dans la file
+    uint64_t finished; //tâches terminées ; recent[(finished - 1) % BOARD_RECENT] est la dernière
+    int64_t boot_ns; //démarrage de l'ordonnanceur (CLOCK_MONOTONIC)
+    BoardEntry recent[BOARD_RECENT];
+    BoardEntry slots[]; //un par worker
+} StatusBoard;
+
+//Taille du segment pour n workers
+size_t board_size(int workers);
+
+//Côté ordonnanceur (toutes acceptent b == NULL : rien n'est publié)
+//Crée (ou remplace) le segment ; NULL si la mémoire partagée est indisponible
+StatusBoard *board_create(int workers, int algo, int quantum_ms);
+
+//Marque l'ordonnanceur arrêté et supprime le segment
+void board_destroy(StatusBoard *b);
+
+//La tâche t tourne (lancement ou reprise) sur le worker slot
+void board_slot_run(StatusBoard *b, int slot, const Task *t);
+
+//Le worker slot est libre (fin ou préemption)
+void board_slot_free(StatusBoard *b, int slot);
+
+//La tâche t est terminée avec ce statut (code de sortie, ou -signal)
+void board_task_done(StatusBoard *b, const Task *t, int status, int64_t cpu_ns);
+
+//Compteurs globaux, à chaque tour de boucle
+void board_update(StatusBoard *b, int running, unsigned long queued);
+
+//Côté lecteur
+//Projette le segment en lecture seule ; NULL (errno) s'il n'existe pas
+const StatusBoard *board_attach(size_t *size);
+void board_detach(const StatusBoard *b, size_t size);
+
+//Copies cohérentes (seqlock) de l'en-tête (sans les entrées) et d'une entrée
+void board_read_header(const StatusBoard *b, StatusBoard *out);
+void board_read_entry(const BoardEntry *e, BoardEntry *out);
+
+//Horloge commune aux deux côtés (CLOCK_MONOTONIC, via le vDSO)
+int64_t board_now_ns(void);
+
+#endif // STATUS_BOARD_H
@@ -0,0 +1,95 @@
+// src/synthetic.c
+#include "synthetic.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#define WRITE_CHUNK (64 * 1024)
+
+int task_is_synthetic(task_type_t type) {
+    return type == TASK_SPIN || type == TASK_SLEEP || type == TASK_WRITE || type == TASK_MEMORY;
+}
+
+static long long cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Temps CPU et non temps réel : une tâche suspendue par SIGSTOP ne
+// consomme rien et reprend là où elle en était
+static int spin(long ms) {
+    long long end = cpu_ns() + ms * 1000000LL;
+    volatile unsigned long x = 0;
+    while (cpu_ns() < end) {
+        for (int i = 0; i < 4096; i++) x += (unsigned long)i;
+    }
+    return 0;
+}
+
+static int sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    while (nanosleep(&ts, &ts) == -1) {
+        if (errno != EINTR) return -1;
+    }
+    return 0;
+}
+
+static int write_file(long kib, const char *path) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        fprintf(stderr, "[synthetic] %s : %s\n", path, strerror(errno));
+        return -1;
+    }
+    static char chunk[WRITE_CHUNK];
+    memset(chunk, 'x', sizeof(chunk));
+    long long left = (long long)kib * 1024;
+    while (left > 0) {
+        size_t len = left < WRITE_CHUNK ? (size_t)left : WRITE_CHUNK;
+        ssize_t n = write(fd, chunk, len);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "[synthetic] écriture %s : %s\n", path, strerror(errno));
+            close(fd);
+            return -1;
+        }
+        left -= n;
+    }
+    int res = fsync(fd);
+    close(fd);
+    return res;
+}
+
+static int touch_memory(long mib) {
+    size_t len = (size_t)mib * 1024 * 1024;
+    char *p = malloc(len ? len : 1);
+    if (!p) {
+        fprintf(stderr, "[synthetic] allocation de %ld Mio impossible\n", mib);
+        return -1;
+    }
+    // volatile : sinon malloc, écritures et free disparaissent à l'optimisation
+    volatile char *v = p;
+    long page = sysconf(_SC_PAGESIZE);
+    for (size_t off = 0; off < len; off += (size_t)page) v[off] = (char)off;
+    free(p);
+    return 0;
+}
+
+void synthetic_run(const Task *t) {
+    long n = t->param1 ? strtol(t->param1, NULL, 10) : 0;
+    if (n < 0) n = 0;
+    int res = -1;
+    switch (t->type) {
+        case TASK_SPIN:   res = spin(n); break;
+        case TASK_SLEEP:  res = sleep_ms(n); break;
+        case TASK_WRITE:  res = t->param2 ? write_file(n, t->param2) : -1; break;
+        case TASK_MEMORY: res = touch_memory(n); break;
+        default: break;
+    }
+    _exit(res == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
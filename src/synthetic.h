@@ -0,0 +1,20 @@
+#ifndef SYNTHETIC_H
+#define SYNTHETIC_H
+
+#include "task.h"
+
+//Tâches synthétiques : charge contrôlée et reproductible pour mesurer
+//l'ordonnanceur sans dépendre d'outils externes (ffmpeg, zstd, git).
+//Exécutées par le binaire de l'ordonnanceur relancé en mode --run-task.
+//  spin   : calcul jusqu'à param1 ms de temps CPU consommé (préemptible)
+//  sleep  : sommeil de param1 ms
+//  write  : écriture de param1 Kio dans param2 (fsync à la fin)
+//  memory : allocation de param1 Mio, une écriture par page
+
+//1 si le type est une tâche synthétique
+int task_is_synthetic(task_type_t type);
+
+//Exécute la tâche dans le processus courant puis le termine (_exit)
+void synthetic_run(const Task *t);
+
+#endif // SYNTHETIC_H
@@ -0,0 +1,611 @@
+// src/tar_stream.c
+#define _GNU_SOURCE
+#include "tar_stream.h"
+#include "zstd_engine.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#define TAR_BLOCK 512
+#define TAR_WALKERS 4                    // threads de parcours
+#define TAR_READERS 4                    // threads de lecture anticipée
+#define TAR_SMALL_FILE (1024 * 1024)     // lu entièrement en avance
+#define TAR_AHEAD_ENTRIES 256            // fichiers préparés d'avance au plus
+#define TAR_AHEAD_BYTES (64 * 1024 * 1024)
+#define TAR_MAX_PENDING 65536            // entrées découvertes non encore écrites
+#define TAR_OUT_BUF (1024 * 1024)
+
+extern char **environ;
+
+// ====== Entrées de l'archive ======
+typedef enum { ENTRY_NEW, ENTRY_LOADING, ENTRY_READY } entry_state_t;
+
+typedef struct TarEntry {
+    char *path;               // chemin sur disque
+    char *name;               // nom dans l'archive
+    char *link;               // cible d'un lien symbolique
+    struct stat st;
+    entry_state_t state;
+    int fd;                   // gros fichier ouvert d'avance (-1 sinon)
+    char *data;               // petit fichier lu d'avance
+    int err;                  // errno si illisible
+    struct TarEntry *next;
+} TarEntry;
+
+typedef struct DirItem {
+    char *path;
+    char *name;
+    struct DirItem *next;
+} DirItem;
+
+typedef struct {
+    pthread_mutex_t mu;
+    pthread_cond_t cv;
+    DirItem *dirs;            // dossiers à parcourir
+    int walking;              // walkers occupés
+    int walk_done;
+    TarEntry *head, *tail;    // entrées dans l'ordre d'écriture
+    TarEntry *prefetch;       // prochaine entrée à préparer
+    int pending;              // entrées dans la liste
+    int ahead;                // entrées préparées non écrites
+    size_t ahead_bytes;       // octets lus d'avance non écrits
+    int errors;
+} TarJob;
+
+static void entry_free(TarEntry *e) {
+    if (e->fd >= 0) close(e->fd);
+    free(e->data);
+    free(e->path);
+    free(e->name);
+    free(e->link);
+    free(e);
+}
+
+static char *join_path(const char *a, const char *b) {
+    size_t la = strlen(a), lb = strlen(b);
+    char *p = malloc(la + lb + 2);
+    if (!p) return NULL;
+    memcpy(p, a, la);
+    p[la] = '/';
+    memcpy(p + la + 1, b, lb + 1);
+    return p;
+}
+
+// Ajoute une entrée en fin de liste (bloque si trop d'entrées en attente)
+static void job_append(TarJob *job, TarEntry *e) {
+    pthread_mutex_lock(&job->mu);
+    while (job->pending >= TAR_MAX_PENDING) {
+        pthread_cond_wait(&job->cv, &job->mu);
+    }
+    if (job->tail) job->tail->next = e;
+    else job->head = e;
+    job->tail = e;
+    if (!job->prefetch) job->prefetch = e;
+    job->pending++;
+    pthread_cond_broadcast(&job->cv);
+    pthread_mutex_unlock(&job->mu);
+}
+
+static TarEntry *make_entry(TarJob *job, char *path, char *name, const struct stat *st) {
+    TarEntry *e = calloc(1, sizeof(TarEntry));
+    if (!e) {
+        free(path);
+        free(name);
+        return NULL;
+    }
+    e->path = path;
+    e->name = name;
+    e->st = *st;
+    e->fd = -1;
+    e->state = S_ISREG(st->st_mode) ? ENTRY_NEW : ENTRY_READY;
+    if (S_ISLNK(st->st_mode)) {
+        size_t cap = (size_t)st->st_size + 1 > 256 ? (size_t)st->st_size + 1 : 256;
+        e->link = malloc(cap);
+        ssize_t n = e->link ? readlink(path, e->link, cap - 1) : -1;
+        if (n < 0) {
+            fprintf(stderr, "[tar] readlink %s: %s\n", path, strerror(errno));
+            __atomic_fetch_add(&job->errors, 1, __ATOMIC_RELAXED);
+            entry_free(e);
+            return NULL;
+        }
+        e->link[n] = '\0';
+    }
+    return e;
+}
+
+// ====== Parcours parallèle ======
+static void walk_dir(TarJob *job, DirItem *d) {
+    DIR *dir = opendir(d->path);
+    if (!dir) {
+        fprintf(stderr, "[tar] %s: %s\n", d->path, strerror(errno));
+        __atomic_fetch_add(&job->errors, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    struct dirent *de;
+    while ((de = readdir(dir)) != NULL) {
+        if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0) continue;
+
+        struct stat st;
+        if (fstatat(dirfd(dir), de->d_name, &st, AT_SYMLINK_NOFOLLOW) == -1) {
+            fprintf(stderr, "[tar] %s/%s: %s\n", d->path, de->d_name, strerror(errno));
+            __atomic_fetch_add(&job->errors, 1, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (!S_ISREG(st.st_mode) && !S_ISDIR(st.st_mode) && !S_ISLNK(st.st_mode)) {
+            fprintf(stderr, "[tar] %s/%s: type de fichier ignoré\n", d->path, de->d_name);
+            continue;
+        }
+        char *path = join_path(d->path, de->d_name);
+        char *name = join_path(d->name, de->d_name);
+        if (!path || !name) {
+            free(path);
+            free(name);
+            __atomic_fetch_add(&job->errors, 1, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        DirItem *sub = NULL;
+        if (S_ISDIR(st.st_mode)) {
+            // Le dossier est ajouté avant son contenu
+            sub = malloc(sizeof(DirItem));
+            char *sub_path = strdup(path), *sub_name = strdup(name);
+            if (!sub || !sub_path || !sub_name) {
+                free(sub);
+                free(sub_path);
+                free(sub_name);
+                sub = NULL;
+                __atomic_fetch_add(&job->errors, 1, __ATOMIC_RELAXED);
+            } else {
+                sub->path = sub_path;
+                sub->name = sub_name;
+            }
+        }
+        TarEntry *e = make_entry(job, path, name, &st);
+        if (e) job_append(job, e);
+        if (sub) {
+            pthread_mutex_lock(&job->mu);
+            sub->next = job->dirs;
+            job->dirs = sub;
+            pthread_cond_broadcast(&job->cv);
+            pthread_mutex_unlock(&job->mu);
+        }
+    }
+    closedir(dir);
+}
+
+static void *walker_main(void *arg) {
+    TarJob *job = arg;
+    pthread_mutex_lock(&job->mu);
+    while (1) {
+        while (!job->dirs && job->walking > 0) {
+            pthread_cond_wait(&job->cv, &job->mu);
+        }
+        if (!job->dirs) break; // plus rien à parcourir ni personne en cours
+        DirItem *d = job->dirs;
+        job->dirs = d->next;
+        job->walking++;
+        pthread_mutex_unlock(&job->mu);
+
+        walk_dir(job, d);
+        free(d->path);
+        free(d->name);
+        free(d);
+
+        pthread_mutex_lock(&job->mu);
+        job->walking--;
+        pthread_cond_broadcast(&job->cv);
+    }
+    job->walk_done = 1;
+    pthread_cond_broadcast(&job->cv);
+    pthread_mutex_unlock(&job->mu);
+    return NULL;
+}
+
+// ====== Lecture anticipée ======
+// Petits fichiers lus en entier, gros fichiers ouverts avec POSIX_FADV_WILLNEED
+static void load_entry(TarEntry *e) {
+    int fd = open(e->path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        e->err = errno;
+        return;
+    }
+    if (e->st.st_size > TAR_SMALL_FILE) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        posix_fadvise(fd, 0, TAR_SMALL_FILE * 8, POSIX_FADV_WILLNEED);
+        e->fd = fd;
+        return;
+    }
+    size_t size = (size_t)e->st.st_size;
+    e->data = malloc(size > 0 ? size : 1);
+    size_t got = 0;
+    while (e->data && got < size) {
+        ssize_t n = read(fd, e->data + got, size - got);
+        if (n == -1 && errno == EINTR) continue;
+        if (n <= 0) break;
+        got += (size_t)n;
+    }
+    if (!e->data) e->err = ENOMEM;
+    else if (got < size) memset(e->data + got, 0, size - got); // fichier raccourci
+    close(fd);
+}
+
+static size_t entry_ahead_bytes(const TarEntry *e) {
+    return e->data ? (size_t)e->st.st_size : 0;
+}
+
+static void *reader_main(void *arg) {
+    TarJob *job = arg;
+    pthread_mutex_lock(&job->mu);
+    while (1) {
+        while (!(job->prefetch && job->ahead < TAR_AHEAD_ENTRIES
+                 && job->ahead_bytes < TAR_AHEAD_BYTES)
+               && !(job->walk_done && !job->prefetch)) {
+            pthread_cond_wait(&job->cv, &job->mu);
+        }
+        if (!job->prefetch) break; // parcours fini et tout est préparé
+        TarEntry *e = job->prefetch;
+        job->prefetch = e->next;
+        if (e->state != ENTRY_NEW) continue;
+        e->state = ENTRY_LOADING;
+        job->ahead++;
+        pthread_mutex_unlock(&job->mu);
+
+        load_entry(e);
+
+        pthread_mutex_lock(&job->mu);
+        e->state = ENTRY_READY;
+        job->ahead_bytes += entry_ahead_bytes(e);
+        pthread_cond_broadcast(&job->cv);
+    }
+    pthread_mutex_unlock(&job->mu);
+    return NULL;
+}
+
+// ====== Sortie : libzstd, ou tube vers l'exécutable zstd ======
+typedef struct {
+    ZstdWriter *zw;
+    int fd;                   // entrée du tube vers zstd (-1 avec libzstd)
+    pid_t pid;
+    int failed;
+    size_t used;
+    char buf[TAR_OUT_BUF];
+} TarOut;
+
+static int out_open(TarOut *o, const char *out_path, int level, int threads) {
+    o->zw = NULL;
+    o->fd = -1;
+    o->pid = -1;
+    o->failed = 0;
+    o->used = 0;
+
+    if (zstd_engine_available()) {
+        int fd = open(out_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd == -1) {
+            fprintf(stderr, "[tar] %s: %s\n", out_path, strerror(errno));
+            return -1;
+        }
+        o->zw = zstd_writer_open(fd, level, threads, 0);
+        if (!o->zw) {
+            close(fd);
+            return -1;
+        }
+        o->fd = fd; // fermé par out_close
+        return 0;
+    }
+
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) == -1) return -1;
+    char t_opt[16], l_opt[16];
+    snprintf(t_opt, sizeof(t_opt), "-T%d", threads);
+    snprintf(l_opt, sizeof(l_opt), "-%d", level);
+    char *argv[] = { "zstd", "-q", "-f", t_opt, l_opt, "-o", (char *)out_path, NULL };
+
+    posix_spawn_file_actions_t fa;
+    posix_spawn_file_actions_init(&fa);
+    posix_spawn_file_actions_adddup2(&fa, fds[0], STDIN_FILENO);
+    int res = posix_spawnp(&o->pid, "zstd", &fa, NULL, argv, environ);
+    posix_spawn_file_actions_destroy(&fa);
+    close(fds[0]);
+    if (res != 0) {
+        fprintf(stderr, "[tar] lancement zstd: %s\n", strerror(res));
+        close(fds[1]);
+        return -1;
+    }
+    o->fd = fds[1];
+    return 0;
+}
+
+static int write_all(int fd, const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static void out_flush(TarOut *o) {
+    if (o->used == 0 || o->failed) {
+        o->used = 0;
+        return;
+    }
+    int res = o->zw ? zstd_writer_write(o->zw, o->buf, o->used)
+                    : write_all(o->fd, o->buf, o->used);
+    if (res == -1) {
+        fprintf(stderr, "[tar] écriture de l'archive: %s\n", strerror(errno));
+        o->failed = 1;
+    }
+    o->used = 0;
+}
+
+static void out_write(TarOut *o, const void *data, size_t len) {
+    const char *p = data;
+    while (len > 0) {
+        size_t room = TAR_OUT_BUF - o->used;
+        size_t n = len < room ? len : room;
+        memcpy(o->buf + o->used, p, n);
+        o->used += n;
+        p += n;
+        len -= n;
+        if (o->used == TAR_OUT_BUF) out_flush(o);
+    }
+}
+
+static void out_zeros(TarOut *o, size_t len) {
+    static const char zeros[TAR_BLOCK];
+    while (len > 0) {
+        size_t n = len < TAR_BLOCK ? len : TAR_BLOCK;
+        out_write(o, zeros, n);
+        len -= n;
+    }
+}
+
+static int out_close(TarOut *o) {
+    out_flush(o);
+    int res = o->failed ? -1 : 0;
+    if (o->zw) {
+        if (zstd_writer_close(o->zw) == -1) res = -1;
+        if (close(o->fd) == -1) res = -1;
+        return res;
+    }
+    close(o->fd);
+    int status;
+    if (waitpid(o->pid, &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "[tar] zstd a échoué\n");
+        res = -1;
+    }
+    return res;
+}
+
+// ====== En-têtes tar ======
+static void put_octal(char *field, size_t width, unsigned long long value) {
+    // width - 1 chiffres + NUL ; au-delà, encodage binaire GNU (base 256)
+    if (width - 1 < 22 && value >= (1ULL << (3 * (width - 1)))) {
+        memset(field, 0, width);
+        field[0] = (char)0x80;
+        for (size_t i = width - 1; i > 0 && value; i--) {
+            field[i] = (char)(value & 0xff);
+            value >>= 8;
+        }
+        return;
+    }
+    snprintf(field, width, "%0*llo", (int)(width - 1), value);
+}
+
+static void put_header(TarOut *o, const char *name, const char *link, char type,
+                       const struct stat *st, unsigned long long size) {
+    char h[TAR_BLOCK];
+    memset(h, 0, sizeof(h));
+    strncpy(h, name, 100);
+    put_octal(h + 100, 8, st ? (st->st_mode & 07777) : 0644);
+    put_octal(h + 108, 8, st ? st->st_uid : 0);
+    put_octal(h + 116, 8, st ? st->st_gid : 0);
+    put_octal(h + 124, 12, size);
+    put_octal(h + 136, 12, st ? (unsigned long long)st->st_mtime : 0);
+    h[156] = type;
+    if (link) strncpy(h + 157, link, 100);
+    memcpy(h + 257, "ustar  ", 8); // format GNU
+    memset(h + 148, ' ', 8);
+    unsigned sum = 0;
+    for (int i = 0; i < TAR_BLOCK; i++) sum += (unsigned char)h[i];
+    snprintf(h + 148, 8, "%06o", sum);
+    h[155] = ' ';
+    out_write(o, h, sizeof(h));
+}
+
+// Nom ou cible > 100 octets : enregistrement GNU ././@LongLink préalable
+static void put_long_name(TarOut *o, char type, const char *value) {
+    size_t len = strlen(value) + 1;
+    put_header(o, "././@LongLink", NULL, type, NULL, len);
+    out_write(o, value, len);
+    out_zeros(o, (TAR_BLOCK - len % TAR_BLOCK) % TAR_BLOCK);
+}
+
+static void write_entry(TarJob *job, TarOut *o, TarEntry *e) {
+    char *dname = NULL;
+    const char *name = e->name;
+    char type;
+    unsigned long long size = 0;
+
+    if (S_ISDIR(e->st.st_mode)) {
+        type = '5';
+        dname = join_path(e->name, ""); // "nom/"
+        if (dname) name = dname;
+    } else if (S_ISLNK(e->st.st_mode)) {
+        type = '2';
+    } else {
+        if (e->err) {
+            fprintf(stderr, "[tar] %s: %s\n", e->path, strerror(e->err));
+            __atomic_fetch_add(&job->errors, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        type = '0';
+        size = (unsigned long long)e->st.st_size;
+    }
+
+    if (strlen(name) > 100) put_long_name(o, 'L', name);
+    if (e->link && strlen(e->link) > 100) put_long_name(o, 'K', e->link);
+    put_header(o, name, e->link, type, &e->st, size);
+    free(dname);
+    if (type != '0') return;
+
+    if (e->data) {
+        out_write(o, e->data, (size_t)size);
+    } else {
+        // Gros fichier : lu au fil de l'eau directement dans le tampon de sortie
+        unsigned long long left = size;
+        while (left > 0) {
+            if (o->used == TAR_OUT_BUF) out_flush(o);
+            size_t room = TAR_OUT_BUF - o->used;
+            size_t want = left < room ? (size_t)left : room;
+            ssize_t n = read(e->fd, o->buf + o->used, want);
+            if (n == -1 && errno == EINTR) continue;
+            if (n <= 0) {
+                fprintf(stderr, "[tar] %s: fichier raccourci pendant l'archivage\n", e->path);
+                __atomic_fetch_add(&job->errors, 1, __ATOMIC_RELAXED);
+                out_zeros(o, (size_t)left);
+                break;
+            }
+            o->used += (size_t)n;
+            left -= (unsigned long long)n;
+        }
+    }
+    out_zeros(o, (TAR_BLOCK - size % TAR_BLOCK) % TAR_BLOCK);
+}
+
+// Racine de l'archive : dernier composant du chemin (sans '/' final)
+static char *root_name(const char *dir) {
+    char *copy = strdup(dir);
+    if (!copy) return NULL;
+    size_t len = strlen(copy);
+    while (len > 1 && copy[len - 1] == '/') copy[--len] = '\0';
+    const char *base = strrchr(copy, '/');
+    char *name = strdup(base && base[1] ? base + 1 : copy);
+    free(copy);
+    return name;
+}
+
+int tar_zstd_directory(const char *dir, const char *out_path, int level, int threads) {
+    struct stat st;
+    if (stat(dir, &st) == -1 || !S_ISDIR(st.st_mode)) {
+        fprintf(stderr, "[tar] %s: pas un dossier\n", dir);
+        return -1;
+    }
+    signal(SIGPIPE, SIG_IGN); // zstd mort : erreur d'écriture plutôt que signal
+
+    TarOut *o = malloc(sizeof(TarOut));
+    if (!o || out_open(o, out_path, level, threads) == -1) {
+        free(o);
+        return -1;
+    }
+
+    TarJob job;
+    memset(&job, 0, sizeof(job));
+    pthread_mutex_init(&job.mu, NULL);
+    pthread_cond_init(&job.cv, NULL);
+
+    // Racine : entrée du dossier lui-même puis son contenu
+    DirItem *root = malloc(sizeof(DirItem));
+    char *rname = root_name(dir);
+    TarEntry *re = NULL;
+    if (root && rname) {
+        root->path = strdup(dir);
+        root->name = rname;
+        root->next = NULL;
+        re = make_entry(&job, strdup(dir), strdup(rname), &st);
+    }
+    if (!re || !root->path) {
+        fprintf(stderr, "[tar] plus de mémoire\n");
+        if (root) free(root->path);
+        free(root);
+        free(rname);
+        out_close(o);
+        free(o);
+        unlink(out_path);
+        return -1;
+    }
+    job_append(&job, re);
+    job.dirs = root;
+
+    pthread_t walkers[TAR_WALKERS], readers[TAR_READERS];
+    int nw = 0, nr = 0;
+    for (; nw < TAR_WALKERS; nw++) {
+        if (pthread_create(&walkers[nw], NULL, walker_main, &job) != 0) break;
+    }
+    for (; nr < TAR_READERS; nr++) {
+        if (pthread_create(&readers[nr], NULL, reader_main, &job) != 0) break;
+    }
+    if (nw == 0) walker_main(&job); // au pire, parcours dans ce thread
+
+    unsigned long files = 0;
+    pthread_mutex_lock(&job.mu);
+    while (1) {
+        while (!job.head && !job.walk_done) {
+            pthread_cond_wait(&job.cv, &job.mu);
+        }
+        TarEntry *e = job.head;
+        if (!e) break;
+        int self_load = 0;
+        if (e->state == ENTRY_NEW) {
+            // Aucun lecteur ne l'a encore prise : on la lit nous-mêmes
+            e->state = ENTRY_LOADING;
+            job.prefetch = e->next;
+            job.ahead++;
+            self_load = 1;
+        }
+        while (!self_load && e->state != ENTRY_READY) {
+            pthread_cond_wait(&job.cv, &job.mu);
+        }
+        if (job.prefetch == e) job.prefetch = e->next;
+        job.head = e->next;
+        if (!job.head) job.tail = NULL;
+        job.pending--;
+        pthread_mutex_unlock(&job.mu);
+
+        if (self_load) load_entry(e);
+        write_entry(&job, o, e);
+        files++;
+
+        pthread_mutex_lock(&job.mu);
+        if (S_ISREG(e->st.st_mode)) {
+            job.ahead--;
+            job.ahead_bytes -= self_load ? 0 : entry_ahead_bytes(e);
+        }
+        pthread_cond_broadcast(&job.cv);
+        pthread_mutex_unlock(&job.mu);
+        entry_free(e);
+        pthread_mutex_lock(&job.mu);
+    }
+    pthread_mutex_unlock(&job.mu);
+
+    for (int i = 0; i < nw; i++) pthread_join(walkers[i], NULL);
+    for (int i = 0; i < nr; i++) pthread_join(readers[i], NULL);
+    pthread_cond_destroy(&job.cv);
+    pthread_mutex_destroy(&job.mu);
+
+    out_zeros(o, 2 * TAR_BLOCK); // fin d'archive
+    int res = out_close(o);
+    free(o);
+    if (res == -1) {
+        unlink(out_path);
+        return -1;
+    }
+    fprintf(stderr, "%s : %lu entrée(s) archivée(s) dans %s%s\n", dir, files, out_path,
+            job.errors ? " (avec erreurs)" : "");
+    return job.errors ? -1 : 0;
+}
@@ -0,0 +1,11 @@
+#ifndef TAR_STREAM_H
+#define TAR_STREAM_H
+
+//Archive un dossier en tar (format GNU : noms longs, tailles > 8 Gio) compressé
+//zstd, en flux : parcours parallèle, lecture anticipée des fichiers,
+//compression au fil de l'eau, sans archive intermédiaire sur disque.
+//Compression par libzstd si disponible, sinon par un processus zstd alimenté
+//par un tube. Retourne 0 si tout a été archivé, -1 sinon (détails sur stderr).
+int tar_zstd_directory(const char *dir, const char *out_path, int level, int threads);
+
+#endif // TAR_STREAM_H
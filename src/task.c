@@ -1,66 +1,107 @@
 #include "task.h"
+#include "output.h"
+#include "task_pool.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>   // strncasecmp
 
 
-//creer une nouvelle tâche en mémoire
-Task *create_task(task_type_t type, int priority, const char *p1, const char *p2) {
-
-    Task *t = (Task*)malloc(sizeof(Task));
-    if (!t) return NULL;
+static unsigned long next_task_id = 1;
 
-    t->pid = -1; //sera fixé après fork
-    t->priority = priority;
-    t->type = type;
-    t->state = READY;
+const char *const task_type_names[TASK_TYPE_COUNT] = TASK_TYPE_NAMES;
+const char *const task_type_labels[TASK_TYPE_COUNT] = TASK_TYPE_LABELS;
 
-    if (p1) {
-        t->param1 = strdup(p1);
-        if (!t->param1) {
-            free(t);
-            return NULL;
+int task_parse_type(const char *s, size_t len, task_type_t *type) {
+    for (int i = 0; i < TASK_TYPE_COUNT; i++) {
+        if ((strlen(task_type_names[i]) == len && strncasecmp(s, task_type_names[i], len) == 0)
+            || (len == 1 && s[0] == '0' + i)) {
+            *type = (task_type_t)i;
+            return 0;
         }
-    } else {
-        t->param1 = NULL;
     }
+    return -1;
+}
 
-    if (p2) {
-        t->param2 = strdup(p2);
-        if (!t->param2) {
-            if (t->param1) free(t->param1);
-            free(t);
+//creer une nouvelle tâche en mémoire
+Task *create_task(task_type_t type, int priority, const char *p1, const char *p2) {
+
+    Task *t = task_pool_alloc();
+    if (!t) return NULL;
+
+    // param1 et param2 à la suite : dans la tâche si possible, sinon dans l'arène
+    size_t len1 = p1 ? strlen(p1) + 1 : 0;
+    size_t len2 = p2 ? strlen(p2) + 1 : 0;
+    char *str = t->inline_str;
+    t->arena = NULL;
+    if (len1 + len2 > sizeof(t->inline_str)) {
+        str = task_arena_alloc(len1 + len2, &t->arena);
+        if (!str) {
+            t->next = NULL;
+            task_pool_free_list(t);
             return NULL;
         }
-    } else {
-        t->param2 = NULL;
     }
+    t->param1 = p1 ? memcpy(str, p1, len1) : NULL;
+    t->param2 = p2 ? memcpy(str + len1, p2, len2) : NULL;
 
+    t->id = __atomic_fetch_add(&next_task_id, 1, __ATOMIC_RELAXED);
+    t->pid = -1; //sera fixé après fork
+    t->priority = priority;
+    t->type = type;
+    t->state = READY;
+    t->zopt.level = COMPRESS_DEFAULT_LEVEL;
+    t->zopt.threads = COMPRESS_DEFAULT_THREADS;
+    t->zopt.frame_mb = 0;
+    memset(&t->seg, 0, sizeof(t->seg));
+    t->seq = 0;
+    t->heap_idx = -1;
+    t->wait_idx = -1;
+    t->class_idx = -1;
+    t->enqueue_ns = 0;
+    t->ready_ns = 0;
+    t->start_ns = 0;
+    t->end_ns = 0;
+    t->wait_ns = 0;
+    t->preemptions = 0;
+    t->level = 0;
+    t->work = 0;
+    t->est_ns = 0;
+    t->deadline_ns = 0;
+    memset(&t->usage, 0, sizeof(t->usage));
+    t->out = NULL;
     t->next = NULL;
     return t;
 }
 
+// Ressources propres à la tâche ; le descripteur lui-même retourne au pool
+static void release_task(Task *t) {
+    task_arena_release(t->arena);
+    output_free(t->out);
+}
+
 //Libère la structure d'une tâche
 void free_task(Task *t) {
     if (!t) return;
-    if (t->param1) free(t->param1);
-    if (t->param2) free(t->param2);
-    free(t);
+    release_task(t);
+    t->next = NULL;
+    task_pool_free_list(t);
+}
+
+//Libère toute une chaîne (next) en un seul retour au pool
+void free_task_list(Task *head) {
+    for (Task *t = head; t; t = t->next) release_task(t);
+    task_pool_free_list(head);
 }
 
 //Affiche une tâche (pour debug).
 void print_task(const Task *t) {
+    fprint_task(stdout, t);
+}
+
+void fprint_task(FILE *f, const Task *t) {
     if (!t) return;
-    //Affichage selon le type
-    const char *type_str = "";
-    switch (t->type) {
-        case TASK_CONV_VIDEO: type_str = "Conversion"; break;
-        case TASK_COMPRESS: type_str = "Compression"; break;
-        case TASK_UPDATE: type_str = "MiseAJour"; break;
-        case TASK_CLONE: type_str = "ClonageGit"; break;
-        default: type_str = "Inconnu"; break;
-        
-    }
+    const char *type_str = task_type_labels[t->type];
     const char *state_str = "";
     switch (t->state) {
         case READY:      state_str = "READY"; break;
@@ -69,7 +110,8 @@ void print_task(const Task *t) {
         default:         state_str = "INCONNU"; break;
     }
 
-    printf("Task: PID=%d | Type=%s | Prio=%d | Etat=%s | Param1=\"%s\" | Param2=\"%s\"\n",
+    fprintf(f, "Task: ID=%lu | PID=%d | Type=%s | Prio=%d | Etat=%s | Param1=\"%s\" | Param2=\"%s\"\n",
+           t->id,
            t->pid,
            type_str,
            t->priority,
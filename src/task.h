@@ -1,6 +1,7 @@
 #ifndef TASK_H
 #define TASK_H
 
+#include <stdio.h>     // pour FILE
 #include <sys/types.h> // pour pid_t
 
 //Types de tâches
@@ -9,7 +10,12 @@ typedef enum {
     TASK_CONV_VIDEO = 0,
     TASK_COMPRESS = 1,
     TASK_UPDATE = 2,
-    TASK_CLONE = 3
+    TASK_CLONE = 3,
+    //Tâches synthétiques (synthetic.h) : charge contrôlée, pour mesurer l'ordonnanceur
+    TASK_SPIN = 4,   //calcul pendant param1 ms de CPU
+    TASK_SLEEP = 5,  //sommeil de param1 ms
+    TASK_WRITE = 6,  //écriture de param1 Kio dans le fichier param2
+    TASK_MEMORY = 7  //allocation de param1 Mio, chaque page touchée
 } task_type_t;
 
 typedef enum {
@@ -18,24 +24,120 @@ typedef enum {
     TERMINATED
 } task_state_t;
 
+//Options de compression zstd (TASK_COMPRESS)
+typedef struct {
+    int level; //niveau zstd (1..19)
+    int threads; //threads de compression (0 = un par CPU)
+    int frame_mb; //format seekable : trames indépendantes de frame_mb Mio (0 = flux unique)
+} CompressOptions;
+
+#define COMPRESS_DEFAULT_LEVEL 3
+#define COMPRESS_DEFAULT_THREADS 1
+
+//Découpage d'une conversion en segments convertis en parallèle (TASK_CONV_VIDEO)
+typedef enum {
+    SEG_NONE = 0, //un seul ffmpeg pour tout le fichier
+    SEG_SPLIT,    //à découper : sondée puis remplacée par ses segments
+    SEG_PART,     //un segment [start, start + length) vers un fichier partiel
+    SEG_CONCAT    //assemblage des fichiers partiels sans réencodage
+} seg_stage_t;
+
+#define SEG_MIN_SECONDS 10.0 //pas de segment plus court
+
+struct Task;
+
+typedef struct {
+    seg_stage_t stage;
+    int count; //segments voulus (SEG_SPLIT) puis produits (SEG_CONCAT)
+    int index; //numéro du segment (SEG_PART)
+    double start; //début du segment en secondes (SEG_PART)
+    double length; //durée du segment en secondes (SEG_PART)
+    int pending; //segments pas encore terminés (SEG_CONCAT)
+    int failed; //au moins un segment a échoué (SEG_CONCAT)
+    struct Task *parent; //tâche d'assemblage (SEG_PART)
+} SegmentInfo;
+
+#define TASK_TYPE_COUNT 8
+
+//Consommation d'une tâche terminée (wait4 et /proc/<pid>/io)
+typedef struct {
+    long long wall_ns; //du premier lancement à la fin (arrêts RR compris)
+    long long user_ns; //CPU en mode utilisateur (ses propres fils récoltés compris)
+    long long sys_ns; //CPU en mode noyau
+    long maxrss_kb; //pic de mémoire résidente
+    long nvcsw; //changements de contexte volontaires (attentes d'E/S, de verrou)
+    long nivcsw; //involontaires (tranche de temps épuisée)
+    unsigned long long rchar, wchar; //octets passés par read/write (tubes compris)
+    unsigned long long read_bytes, write_bytes; //octets réellement lus/écrits sur le stockage
+} TaskUsage;
+
+struct TaskOutput; //sortie capturée (output.h)
+
+//Place pour param1 et param2 dans la tâche elle-même (Task tient en 6 lignes de cache)
+#define TASK_INLINE_STR 80
+
 //Structure de description d'une tâche
 typedef struct Task {
+    unsigned long id; //identifiant unique (ordre de création)
     int pid; //pid du fils
     int priority; //priorité pour ordonnancement PRIORITY
     task_type_t type; //quel type de tâche (conversion, compression)
     char *param1; //paramètre 1: chemin ou URL
     char *param2; //param2 : chemin de sortie du dossier
+    CompressOptions zopt; //options zstd (TASK_COMPRESS)
+    SegmentInfo seg; //conversion segmentée (TASK_CONV_VIDEO)
+    unsigned long seq; //numéro d'arrivée dans la file (départage FIFO)
     task_state_t state; //etat de la tâche
+    int heap_idx; //position dans le tas de la file (-1 si hors file)
+    int wait_idx; //position dans le tas d'ancienneté (attente maximale, -1 si hors file)
+    int class_idx; //position dans le tas de sa classe (partage équitable, -1 si hors file)
+    //Horodatages (monotonic_ns, 0 : pas encore)
+    long long enqueue_ns; //première entrée dans la file (arrivée)
+    long long ready_ns; //dernière entrée dans la file (arrivée ou préemption)
+    long long start_ns; //premier lancement
+    long long end_ns; //fin du fils
+    long long wait_ns; //temps cumulé passé dans la file
+    int preemptions; //fins de quantum avec remise en file
+    int level; //niveau MLFQ (0 : le plus prioritaire)
+    long long work; //unités de travail pour l'estimation (estimate.h, 0 : inconnues)
+    long long est_ns; //durée d'exécution estimée (0 : pas encore estimée)
+    long long deadline_ns; //échéance (monotonic_ns, 0 : aucune) pour EDF
+    struct TaskOutput *out; //tube de sortie du fils (NULL tant qu'il n'existe pas)
+    TaskUsage usage; //consommation, relevée à la récolte du fils
     struct Task *next; //pour enchainer dan la file
+    void *arena; //bloc de l'arène portant param1/param2 (NULL : stockage en ligne)
+    char inline_str[TASK_INLINE_STR]; //param1 et param2 quand ils tiennent ici
 } Task;
 
+//Contenu des tables ci-dessous, par type ; aussi pour les outils qui ne lient
+//pas task.o (scheduler-top)
+#define TASK_TYPE_NAMES { "convert", "compress", "update", "clone", \
+                          "spin", "sleep", "write", "memory" }
+#define TASK_TYPE_LABELS { "Conversion", "Compression", "MiseAJour", "ClonageGit", \
+                           "Calcul", "Sommeil", "Ecriture", "Memoire" }
+
+//Noms courts des types, ceux des manifestes, des options et des exports
+//("convert", "compress", ...)
+extern const char *const task_type_names[TASK_TYPE_COUNT];
+
+//Libellés des types pour le journal et les tableaux ("Conversion", ...)
+extern const char *const task_type_labels[TASK_TYPE_COUNT];
+
+//Nom (sans casse) ou numéro ("1") de type, sur les len premiers caractères
+//de s -> *type ; -1 si inconnu
+int task_parse_type(const char *s, size_t len, task_type_t *type);
+
 //Créer une tâche (les chaînes p1 et p2 sont dupliquées)
 Task *create_task(task_type_t type, int priority, const char *p1, const char *p2);
 
 //Libérer une tâche
 void free_task(Task *t);
 
+//Libérer d'un coup une chaîne de tâches liées par next (fin d'un lot)
+void free_task_list(Task *head);
+
 //Afficher la tâche (pour print_queue)
 void print_task(const Task *t);
+void fprint_task(FILE *f, const Task *t);
 
 #endif // TASK_H
\ No newline at end of file
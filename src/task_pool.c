@@ -0,0 +1,182 @@
+// src/task_pool.c
+#include "task_pool.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define CACHE_LINE 64
+
+// Pas entre deux tâches d'un slab : chaque tâche commence sur une ligne de cache
+#define TASK_STRIDE ((sizeof(Task) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE)
+
+// ====== Cache par thread et dépôt commun ======
+// Les tâches libres sont chaînées par next. Un thread puise dans son cache
+// sans verrou ; le dépôt (mutex) n'est touché que par lots de TASK_SLAB_TASKS.
+typedef struct {
+    Task *head;
+    int count;
+} TaskCache;
+
+static __thread TaskCache cache;
+
+static struct {
+    pthread_mutex_t mutex;
+    Task *head;
+    int count;
+} depot = { PTHREAD_MUTEX_INITIALIZER, NULL, 0 };
+
+static pthread_key_t cache_key;
+static pthread_once_t cache_once = PTHREAD_ONCE_INIT;
+
+// Rend au dépôt la chaîne first..last de n tâches
+static void depot_put(Task *first, Task *last, int n) {
+    pthread_mutex_lock(&depot.mutex);
+    last->next = depot.head;
+    depot.head = first;
+    depot.count += n;
+    pthread_mutex_unlock(&depot.mutex);
+}
+
+// À la fin d'un thread, son cache retourne au dépôt
+static void cache_release(void *arg) {
+    TaskCache *c = arg;
+    if (!c->head) return;
+    Task *last = c->head;
+    while (last->next) last = last->next;
+    depot_put(c->head, last, c->count);
+    c->head = NULL;
+    c->count = 0;
+}
+
+static void cache_key_init(void) {
+    pthread_key_create(&cache_key, cache_release);
+}
+
+// Premier usage du cache dans ce thread : prévoir son retour au dépôt
+static void cache_register(void) {
+    pthread_once(&cache_once, cache_key_init);
+    if (!pthread_getspecific(cache_key)) pthread_setspecific(cache_key, &cache);
+}
+
+// Remplit le cache vide : un lot du dépôt, sinon un nouveau slab
+static int cache_refill(void) {
+    cache_register();
+
+    pthread_mutex_lock(&depot.mutex);
+    if (depot.head) {
+        Task *first = depot.head, *last = first;
+        int n = 1;
+        while (n < TASK_SLAB_TASKS && last->next) {
+            last = last->next;
+            n++;
+        }
+        depot.head = last->next;
+        depot.count -= n;
+        pthread_mutex_unlock(&depot.mutex);
+        last->next = NULL;
+        cache.head = first;
+        cache.count = n;
+        return 0;
+    }
+    pthread_mutex_unlock(&depot.mutex);
+
+    // Les slabs ne sont jamais rendus au système : les tâches y circulent
+    void *slab;
+    if (posix_memalign(&slab, CACHE_LINE, TASK_SLAB_TASKS * TASK_STRIDE) != 0) return -1;
+    for (int i = TASK_SLAB_TASKS - 1; i >= 0; i--) {
+        Task *t = (Task *)((char *)slab + (size_t)i * TASK_STRIDE);
+        t->next = cache.head;
+        cache.head = t;
+    }
+    cache.count = TASK_SLAB_TASKS;
+    return 0;
+}
+
+Task *task_pool_alloc(void) {
+    if (!cache.head && cache_refill() == -1) return NULL;
+    Task *t = cache.head;
+    cache.head = t->next;
+    cache.count--;
+    return t;
+}
+
+void task_pool_free_list(Task *head) {
+    if (!head) return;
+    Task *last = head;
+    int n = 1;
+    while (last->next) {
+        last = last->next;
+        n++;
+    }
+    last->next = cache.head;
+    cache.head = head;
+    cache.count += n;
+    if (cache.count <= TASK_CACHE_MAX) return;
+
+    // Trop de tâches libres ici (typiquement le thread qui libère) : on garde
+    // un lot et on rend le reste au dépôt pour le thread qui soumet
+    cache_register();
+    Task *keep_last = cache.head;
+    for (int i = 1; i < TASK_SLAB_TASKS; i++) keep_last = keep_last->next;
+    Task *first = keep_last->next;
+    Task *tail = first;
+    while (tail->next) tail = tail->next;
+    keep_last->next = NULL;
+    depot_put(first, tail, cache.count - TASK_SLAB_TASKS);
+    cache.count = TASK_SLAB_TASKS;
+}
+
+// ====== Arène des chaînes longues ======
+// Allocation par pointeur croissant dans des blocs de TASK_ARENA_CHUNK ;
+// chaque bloc compte ses allocations vivantes et disparaît quand il est vide.
+typedef struct ArenaChunk {
+    size_t used;
+    size_t cap;
+    int live;
+    char data[];
+} ArenaChunk;
+
+static pthread_mutex_t arena_mutex = PTHREAD_MUTEX_INITIALIZER;
+static ArenaChunk *arena_current;
+
+char *task_arena_alloc(size_t len, void **chunk) {
+    pthread_mutex_lock(&arena_mutex);
+    ArenaChunk *c = arena_current;
+    if (!c || c->cap - c->used < len) {
+        // Chaîne énorme : bloc dédié, le bloc courant reste en service
+        size_t cap = len > TASK_ARENA_CHUNK / 4 ? len : TASK_ARENA_CHUNK;
+        c = malloc(sizeof(ArenaChunk) + cap);
+        if (!c) {
+            pthread_mutex_unlock(&arena_mutex);
+            return NULL;
+        }
+        c->used = 0;
+        c->cap = cap;
+        c->live = 0;
+        if (cap == TASK_ARENA_CHUNK) {
+            if (arena_current && arena_current->live == 0) free(arena_current);
+            arena_current = c;
+        }
+    }
+    char *p = c->data + c->used;
+    c->used += len;
+    c->live++;
+    pthread_mutex_unlock(&arena_mutex);
+    *chunk = c;
+    return p;
+}
+
+void task_arena_release(void *chunk) {
+    ArenaChunk *c = chunk;
+    if (!c) return;
+    pthread_mutex_lock(&arena_mutex);
+    if (--c->live == 0) {
+        if (c == arena_current) {
+            c->used = 0; // bloc courant vide : on le réutilise depuis le début
+        } else {
+            free(c);
+        }
+    }
+    pthread_mutex_unlock(&arena_mutex);
+}
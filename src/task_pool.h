@@ -0,0 +1,28 @@
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <stddef.h>
+#include "task.h"
+
+//Allocateur des descripteurs Task : slabs alignés sur la ligne de cache,
+//cache de tâches libres par thread, dépôt commun pour les échanges entre
+//le thread qui soumet et celui qui libère
+#define TASK_SLAB_TASKS 64 //tâches par slab (et par transfert avec le dépôt)
+#define TASK_CACHE_MAX (2 * TASK_SLAB_TASKS) //au-delà, le cache rend un lot au dépôt
+
+//Arène des chaînes trop longues pour le stockage en ligne de la tâche
+#define TASK_ARENA_CHUNK (64 * 1024)
+
+//Tâche non initialisée (NULL si plus de mémoire)
+Task *task_pool_alloc(void);
+
+//Rendre une chaîne de tâches (liées par next) au cache du thread courant
+void task_pool_free_list(Task *head);
+
+//Réserver len octets dans l'arène ; *chunk reçoit le bloc à rendre ensuite
+char *task_arena_alloc(size_t len, void **chunk);
+
+//Rendre une allocation de l'arène (le bloc est libéré quand il est vide)
+void task_arena_release(void *chunk);
+
+#endif // TASK_POOL_H
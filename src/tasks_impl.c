@@ -1,22 +1,31 @@
 // src/tasks_impl.c
-#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE    // pipe2
 #include "tasks_impl.h"
 #include "task.h"
+#include "log.h"  // LOGFILE
+#include "zstd_engine.h"
+#include "tar_stream.h"
+#include "synthetic.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>    // execlp, getpid, dup2, getuid
-#include <fcntl.h>     // open
+#include <fcntl.h>     // open, O_CLOEXEC
 #include <string.h>
+#include <strings.h>   // strcasecmp
+#include <stdarg.h>
+#include <signal.h>
+#include <spawn.h>     // posix_spawnp
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <errno.h>
+#include <math.h>      // isfinite
 
-#define LOGFILE "/tmp/scheduler.log"
+extern char **environ;
 
-// Redirige stdout et stderr vers le fichier de log (append)
-static void redirect_output_to_log(void) {
-    int fd = open(LOGFILE, O_WRONLY | O_APPEND);
+// Redirige stdout et stderr vers out_fd, ou vers le fichier de log (append)
+static void redirect_output(int out_fd) {
+    int fd = out_fd >= 0 ? out_fd : open(LOGFILE, O_WRONLY | O_APPEND);
     if (fd == -1) {
         perror("[tasks_impl] Erreur ouverture LOGFILE pour redirection");
         return;
@@ -81,135 +90,399 @@ static char *make_ffmpeg_output(const char *input_path) {
     return out;
 }
 
+// Commande externe d'une tâche, prête pour execvp / posix_spawnp
+#define CMD_MAX_ARGS 24
+
+typedef struct {
+    char *argv[CMD_MAX_ARGS];
+    char *owned;          // chaîne allouée référencée par argv (nom de sortie)
+    const char *env;      // variable "NOM=valeur" à ajouter (NULL si aucune)
+    char opt[3][16];      // options numériques formatées (zstd, --run-task)
+} TaskCommand;
+
+static void cmd_set(TaskCommand *cmd, int argc, ...) {
+    va_list args;
+    va_start(args, argc);
+    for (int i = 0; i < argc && i < CMD_MAX_ARGS - 1; i++) {
+        cmd->argv[i] = va_arg(args, char *);
+    }
+    cmd->argv[argc < CMD_MAX_ARGS - 1 ? argc : CMD_MAX_ARGS - 1] = NULL;
+    va_end(args);
+}
+
 // ====== Compression de fichier ======
-static void task_compress(Task *t) {
-    redirect_output_to_log();
+// Les fichiers audio/vidéo sont réencodés par ffmpeg, le reste passe par zstd
+static int is_media_input(const Task *t) {
     const char *inPath = t->param1;
-    const char *outPath = t->param2; // sert uniquement pour zstd
+    return is_regular_file(inPath) && (is_video_file(inPath) || is_audio_file(inPath));
+}
+
+static int is_directory(const char *path) {
+    struct stat st;
+    if (stat(path, &st) == -1) return 0;
+    return S_ISDIR(st.st_mode);
+}
+
+// Sortie zstd : param2, ou "<entrée>.zst" ("<dossier>.tar.zst" pour un dossier)
+// (à libérer par l'appelant si *owned)
+static char *zstd_output_path(const Task *t, char **owned) {
+    *owned = NULL;
+    if (t->param2 && strcmp(t->param2, t->param1) != 0) return t->param2;
+    size_t len = strlen(t->param1);
+    *owned = malloc(len + 9);
+    if (!*owned) {
+        fprintf(stderr, "[tasks_impl] Erreur allocation pour zstd output\n");
+        return NULL;
+    }
+    if (is_directory(t->param1)) {
+        while (len > 1 && t->param1[len - 1] == '/') len--;
+        sprintf(*owned, "%.*s.tar.zst", (int)len, t->param1);
+    } else {
+        sprintf(*owned, "%s.zst", t->param1);
+    }
+    return *owned;
+}
+
+// Exécutée par le binaire de l'ordonnanceur lui-même (RUN_TASK_EXE
+// --run-task) plutôt que par un outil externe : les tâches synthétiques, et
+// pour zstd les dossiers (archive tar en flux) et, avec libzstd, tous les
+// fichiers non multimédia
+static int runs_in_process(const Task *t) {
+    if (task_is_synthetic(t->type)) return 1;
+    if (t->type != TASK_COMPRESS) return 0;
+    if (is_directory(t->param1)) return 1;
+    return zstd_engine_available() && !is_media_input(t);
+}
+
+// Écrit seulement sur stderr (non tamponné), comme les commandes externes
+static void compress_in_process(const Task *t) {
+    char *owned;
+    const char *outPath = zstd_output_path(t, &owned);
+    if (!outPath) _exit(EXIT_FAILURE);
+    int res;
+    if (is_directory(t->param1)) {
+        res = tar_zstd_directory(t->param1, outPath, t->zopt.level, t->zopt.threads);
+    } else if (t->zopt.frame_mb > 0) {
+        res = zstd_compress_seekable(t->param1, outPath, t->zopt.level, t->zopt.threads,
+                                     (size_t)t->zopt.frame_mb * 1024 * 1024);
+    } else {
+        res = zstd_compress_file(t->param1, outPath, t->zopt.level, t->zopt.threads);
+    }
+    free(owned);
+    _exit(res == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+static void run_in_process(const Task *t) {
+    if (task_is_synthetic(t->type)) synthetic_run(t);
+    compress_in_process(t);
+}
+
+// Le binaire courant, relancé par exec : rien de l'ordonnanceur (threads,
+// verrous, tas) n'est hérité par la tâche
+#define RUN_TASK_EXE "/proc/self/exe"
+
+// RUN_TASK_EXE --run-task TYPE PARAM1 PARAM2 NIVEAU THREADS TRAME_MIO
+// (PARAM2 vide : absent), relu par run_task_main()
+static int build_run_task(const Task *t, TaskCommand *cmd) {
+    snprintf(cmd->opt[0], sizeof(cmd->opt[0]), "%d", t->zopt.level);
+    snprintf(cmd->opt[1], sizeof(cmd->opt[1]), "%d", t->zopt.threads);
+    snprintf(cmd->opt[2], sizeof(cmd->opt[2]), "%d", t->zopt.frame_mb);
+    cmd_set(cmd, 8, RUN_TASK_EXE, "--run-task", (char *)task_type_names[t->type],
+            t->param1 ? t->param1 : "", t->param2 ? t->param2 : "",
+            cmd->opt[0], cmd->opt[1], cmd->opt[2]);
+    return 0;
+}
+
+int run_task_main(int argc, char **argv) {
+    Task t;
+    memset(&t, 0, sizeof(t));
+    if (argc != 6 || task_parse_type(argv[0], strlen(argv[0]), &t.type) == -1
+        || (!task_is_synthetic(t.type) && t.type != TASK_COMPRESS)) {
+        fprintf(stderr, "[tasks_impl] --run-task : arguments invalides\n");
+        return EXIT_FAILURE;
+    }
+    t.param1 = argv[1][0] ? argv[1] : NULL;
+    t.param2 = argv[2][0] ? argv[2] : NULL;
+    t.zopt.level = atoi(argv[3]);
+    t.zopt.threads = atoi(argv[4]);
+    t.zopt.frame_mb = atoi(argv[5]);
+    if (!t.param1) {
+        fprintf(stderr, "[tasks_impl] --run-task : paramètre manquant\n");
+        return EXIT_FAILURE;
+    }
+    run_in_process(&t);
+    return EXIT_FAILURE;
+}
+
+static int build_compress(const Task *t, TaskCommand *cmd) {
+    char *inPath = t->param1;
 
     // Si c'est un fichier audio/vidéo → ffmpeg
-    if (is_regular_file(inPath) && (is_video_file(inPath) || is_audio_file(inPath))) {
-        char *ffout = make_ffmpeg_output(inPath);
-        if (!ffout) {
+    if (is_media_input(t)) {
+        cmd->owned = make_ffmpeg_output(inPath);
+        if (!cmd->owned) {
             fprintf(stderr, "[tasks_impl] Erreur allocation pour ffmpeg output\n");
-            _exit(EXIT_FAILURE);
+            return -1;
         }
-
         if (is_video_file(inPath)) {
             // Réencoder la vidéo avec CRF=35 et audio à 96k
-            execlp("ffmpeg", "ffmpeg",
-                   "-i", inPath,
-                   "-c:v", "libx264", "-crf", "35", "-preset", "medium",
-                   "-c:a", "aac", "-b:a", "96k",
-                   ffout,
-                   (char *)NULL);
-            fprintf(stderr, "[tasks_impl] execlp ffmpeg (video) failed: %s\n", strerror(errno));
+            cmd_set(cmd, 14, "ffmpeg", "-i", inPath,
+                    "-c:v", "libx264", "-crf", "35", "-preset", "medium",
+                    "-c:a", "aac", "-b:a", "96k", cmd->owned);
         } else {
             // Fichier audio → réencoder en MP3 128k
-            execlp("ffmpeg", "ffmpeg",
-                   "-i", inPath,
-                   "-c:a", "libmp3lame", "-b:a", "128k",
-                   ffout,
-                   (char *)NULL);
-            fprintf(stderr, "[tasks_impl] execlp ffmpeg (audio) failed: %s\n", strerror(errno));
+            cmd_set(cmd, 8, "ffmpeg", "-i", inPath,
+                    "-c:a", "libmp3lame", "-b:a", "128k", cmd->owned);
         }
-        free(ffout);
-        _exit(EXIT_FAILURE);
+        return 0;
     }
 
-    // Cas générique (autres fichiers ou dossiers) → zstd
-    char *zstd_out = NULL;
-    if (!outPath || strcmp(outPath, inPath) == 0) {
-        size_t len = strlen(inPath);
-        zstd_out = malloc(len + 5);
-        if (!zstd_out) {
-            fprintf(stderr, "[tasks_impl] Erreur allocation pour zstd output\n");
-            _exit(EXIT_FAILURE);
+    // Cas générique (autres fichiers) → zstd
+    char *outPath = zstd_output_path(t, &cmd->owned);
+    if (!outPath) return -1;
+
+    snprintf(cmd->opt[0], sizeof(cmd->opt[0]), "-T%d", t->zopt.threads);
+    snprintf(cmd->opt[1], sizeof(cmd->opt[1]), "-%d", t->zopt.level);
+    cmd_set(cmd, 6, "zstd", cmd->opt[0], cmd->opt[1], inPath, "-o", outPath);
+    return 0;
+}
+
+// ====== Conversion vidéo → audio ======
+// Liste du demuxer concat de ffmpeg : "<sortie>.parts.txt"
+static char *concat_list_path(const char *out) {
+    char *path = malloc(strlen(out) + sizeof(".parts.txt"));
+    if (path) sprintf(path, "%s.parts.txt", out);
+    return path;
+}
+
+// "dir/nom.ext" -> "dir/nom.part03.ext" (l'extension garde le format de sortie)
+char *segment_part_path(const char *out, int index) {
+    const char *slash = strrchr(out, '/');
+    const char *dot = strrchr(out, '.');
+    size_t base_len = dot && (!slash || dot > slash + 1) ? (size_t)(dot - out) : strlen(out);
+    char *path = malloc(strlen(out) + 16);
+    if (!path) return NULL;
+    sprintf(path, "%.*s.part%02d%s", (int)base_len, out, index, out + base_len);
+    return path;
+}
+
+// Écrit la liste des segments, chemins relatifs au dossier de la liste
+static int write_concat_list(const Task *t, const char *list) {
+    FILE *f = fopen(list, "w");
+    if (!f) {
+        fprintf(stderr, "[tasks_impl] %s: %s\n", list, strerror(errno));
+        return -1;
+    }
+    for (int i = 0; i < t->seg.count; i++) {
+        char *part = segment_part_path(t->param2, i);
+        if (!part) {
+            fclose(f);
+            return -1;
         }
-        sprintf(zstd_out, "%s.zst", inPath);
-        outPath = zstd_out;
+        const char *name = strrchr(part, '/') ? strrchr(part, '/') + 1 : part;
+        fputs("file '", f);
+        for (const char *c = name; *c; c++) {
+            if (*c == '\'') fputs("'\\''", f);
+            else fputc(*c, f);
+        }
+        fputs("'\n", f);
+        free(part);
     }
+    return fclose(f) == 0 ? 0 : -1;
+}
 
-    char threads_opt[16], level_opt[16];
-    snprintf(threads_opt, sizeof(threads_opt), "-T%d", 1);
-    snprintf(level_opt, sizeof(level_opt), "-%d", 3);
+void segment_cleanup(const Task *t) {
+    for (int i = 0; i < t->seg.count; i++) {
+        char *part = segment_part_path(t->param2, i);
+        if (part) unlink(part);
+        free(part);
+    }
+    char *list = concat_list_path(t->param2);
+    if (list) unlink(list);
+    free(list);
+}
 
-    execlp("zstd", "zstd",
-           threads_opt, level_opt,
-           inPath,
-           "-o", outPath,
-           (char *)NULL);
-    fprintf(stderr, "[tasks_impl] execlp zstd failed: %s\n", strerror(errno));
-    if (zstd_out) free(zstd_out);
-    _exit(EXIT_FAILURE);
+static int build_convert(const Task *t, TaskCommand *cmd) {
+    switch (t->seg.stage) {
+        case SEG_PART:
+            // -ss avant -i : recherche rapide, le décodage repart à la bonne position
+            snprintf(cmd->opt[0], sizeof(cmd->opt[0]), "%.3f", t->seg.start);
+            snprintf(cmd->opt[1], sizeof(cmd->opt[1]), "%.3f", t->seg.length);
+            cmd_set(cmd, 14, "ffmpeg", "-nostdin", "-y", "-ss", cmd->opt[0], "-t", cmd->opt[1],
+                    "-i", t->param1, "-q:a", "0", "-map", "a", t->param2);
+            return 0;
+        case SEG_CONCAT:
+            // Assemblage sans réencodage des segments déjà convertis
+            cmd->owned = concat_list_path(t->param2);
+            if (!cmd->owned || write_concat_list(t, cmd->owned) == -1) {
+                free(cmd->owned);
+                cmd->owned = NULL;
+                return -1;
+            }
+            cmd_set(cmd, 12, "ffmpeg", "-nostdin", "-y", "-f", "concat", "-safe", "0",
+                    "-i", cmd->owned, "-c", "copy", t->param2);
+            return 0;
+        default:
+            cmd_set(cmd, 8, "ffmpeg", "-i", t->param1, "-q:a", "0", "-map", "a", t->param2);
+            return 0;
+    }
 }
 
-// ====== Conversion vidéo → audio ======
-static void task_convert(Task *t) {
-    redirect_output_to_log();
-    execlp("ffmpeg", "ffmpeg",
-           "-i", t->param1,
-           "-q:a", "0", "-map", "a",
-           t->param2,
-           (char *)NULL);
-    fprintf(stderr, "[tasks_impl] execlp ffmpeg conversion failed: %s\n", strerror(errno));
-    _exit(EXIT_FAILURE);
+pid_t probe_media_spawn(const char *path, int *out_fd) {
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) == -1) return -1;
+    posix_spawn_file_actions_t fa;
+    posix_spawn_file_actions_init(&fa);
+    posix_spawn_file_actions_addopen(&fa, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&fa, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addopen(&fa, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addclose(&fa, fds[0]);
+    posix_spawn_file_actions_addclose(&fa, fds[1]);
+    char *argv[] = { "ffprobe", "-v", "error", "-show_entries", "format=duration",
+                     "-of", "default=noprint_wrappers=1:nokey=1", (char *)path, NULL };
+    pid_t pid;
+    int err = posix_spawnp(&pid, argv[0], &fa, NULL, argv, environ);
+    posix_spawn_file_actions_destroy(&fa);
+    close(fds[1]);
+    if (err != 0) {
+        close(fds[0]);
+        errno = err;
+        return -1;
+    }
+    *out_fd = fds[0];
+    return pid;
+}
+
+double probe_media_read(int fd) {
+    char buf[64];
+    size_t len = 0;
+    ssize_t n;
+    while (len < sizeof(buf) - 1
+           && ((n = read(fd, buf + len, sizeof(buf) - 1 - len)) > 0 || (n == -1 && errno == EINTR))) {
+        if (n > 0) len += (size_t)n;
+    }
+    buf[len] = '\0';
+    close(fd);
+    char *end;
+    double d = strtod(buf, &end);
+    return end != buf && isfinite(d) && d > 0 ? d : -1;
 }
 
 // ====== Mise à jour du système ======
-static void task_update(Task *t) {
+static int build_update(const Task *t, TaskCommand *cmd) {
     (void)t;
-    redirect_output_to_log();
-
     if (getuid() == 0) {
         // Si on est root, on n'utilise pas sudo
-        int code = system("apt update && apt upgrade -y");
-        if (code == -1) {
-            fprintf(stderr, "[tasks_impl] system \"apt update && apt upgrade -y\" failed: %s\n", strerror(errno));
-            _exit(EXIT_FAILURE);
-        }
-        _exit(EXIT_SUCCESS);
-    }
-
-    // Sinon, on tente en mode non interactif,
-    // si l'utilisateur a mis NOPASSWD dans sudoers pour apt
-    {
-        int code = system("sudo -n apt update && sudo -n apt upgrade -y");
-        if (code == -1) {
-            fprintf(stderr, "[tasks_impl] system \"sudo -n apt update && sudo -n apt upgrade -y\" failed: %s\n", strerror(errno));
-            _exit(EXIT_FAILURE);
-        }
-        _exit(EXIT_SUCCESS);
+        cmd_set(cmd, 3, "sh", "-c", "apt update && apt upgrade -y");
+    } else {
+        // Sinon, on tente en mode non interactif,
+        // si l'utilisateur a mis NOPASSWD dans sudoers pour apt
+        cmd_set(cmd, 3, "sh", "-c", "sudo -n apt update && sudo -n apt upgrade -y");
     }
+    return 0;
 }
 
 // ====== Clonage Git ======
-static void task_clone(Task *t) {
-    redirect_output_to_log();
+static int build_clone(const Task *t, TaskCommand *cmd) {
     // Désactiver prompt SSH (passphrase) :
-    setenv("GIT_TERMINAL_PROMPT", "0", 1);
-
-    execlp("git", "git", "clone", t->param1, t->param2, (char *)NULL);
-    fprintf(stderr, "[tasks_impl] execlp git clone failed: %s\n", strerror(errno));
-    _exit(EXIT_FAILURE);
+    cmd->env = "GIT_TERMINAL_PROMPT=0";
+    cmd_set(cmd, 4, "git", "clone", t->param1, t->param2);
+    return 0;
 }
 
-void execute_task(Task *t) {
+static int build_command(const Task *t, TaskCommand *cmd) {
+    memset(cmd, 0, sizeof(*cmd));
     switch (t->type) {
-        case TASK_COMPRESS:
-            task_compress(t);
-            break;
-        case TASK_CONV_VIDEO:
-            task_convert(t);
-            break;
-        case TASK_UPDATE:
-            task_update(t);
-            break;
-        case TASK_CLONE:
-            task_clone(t);
-            break;
+        case TASK_COMPRESS:   return build_compress(t, cmd);
+        case TASK_CONV_VIDEO: return build_convert(t, cmd);
+        case TASK_UPDATE:     return build_update(t, cmd);
+        case TASK_CLONE:      return build_clone(t, cmd);
         default:
             fprintf(stderr, "[tasks_impl] Type de tâche inconnu: %d\n", t->type);
-            _exit(EXIT_FAILURE);
+            return -1;
+    }
+}
+
+// Commande externe, ou le binaire courant en mode --run-task
+static int build_task(const Task *t, TaskCommand *cmd) {
+    if (!runs_in_process(t)) return build_command(t, cmd);
+    memset(cmd, 0, sizeof(*cmd));
+    return build_run_task(t, cmd);
+}
+
+void execute_task(Task *t, int out_fd) {
+    redirect_output(out_fd);
+    TaskCommand cmd;
+    if (build_task(t, &cmd) == -1) {
+        _exit(EXIT_FAILURE);
+    }
+    if (cmd.env) {
+        char name[64];
+        size_t len = strcspn(cmd.env, "=");
+        if (len < sizeof(name)) {
+            memcpy(name, cmd.env, len);
+            name[len] = '\0';
+            setenv(name, cmd.env + len + 1, 1);
+        }
+    }
+    execvp(cmd.argv[0], cmd.argv);
+    fprintf(stderr, "[tasks_impl] execvp %s failed: %s\n", cmd.argv[0], strerror(errno));
+    _exit(EXIT_FAILURE);
+}
+
+// Environnement du parent + la variable propre à la commande
+static char **build_envp(const char *extra) {
+    size_t n = 0;
+    while (environ[n]) n++;
+    char **envp = malloc((n + 2) * sizeof(char *));
+    if (!envp) return NULL;
+    memcpy(envp, environ, n * sizeof(char *));
+    envp[n] = (char *)extra;
+    envp[n + 1] = NULL;
+    return envp;
+}
+
+pid_t spawn_task(const Task *t, int out_fd) {
+    TaskCommand cmd;
+    if (build_task(t, &cmd) == -1) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    posix_spawn_file_actions_t fa;
+    posix_spawnattr_t attr;
+    posix_spawn_file_actions_init(&fa);
+    posix_spawnattr_init(&attr);
+
+    // stdin détaché du terminal, stdout/stderr vers le tube de la tâche (ou le log)
+    posix_spawn_file_actions_addopen(&fa, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    if (out_fd >= 0) {
+        posix_spawn_file_actions_adddup2(&fa, out_fd, STDOUT_FILENO);
+    } else {
+        posix_spawn_file_actions_addopen(&fa, STDOUT_FILENO, LOGFILE,
+                                         O_WRONLY | O_APPEND | O_CREAT, 0644);
+    }
+    posix_spawn_file_actions_adddup2(&fa, STDOUT_FILENO, STDERR_FILENO);
+
+    // Groupe de processus propre (Ctrl+C ne l'atteint pas) et masque vide
+    sigset_t empty;
+    sigemptyset(&empty);
+    posix_spawnattr_setpgroup(&attr, 0);
+    posix_spawnattr_setsigmask(&attr, &empty);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGMASK);
+
+    char **envp = cmd.env ? build_envp(cmd.env) : environ;
+    pid_t pid = -1;
+    int res = envp ? posix_spawnp(&pid, cmd.argv[0], &fa, &attr, cmd.argv, envp) : ENOMEM;
+
+    if (envp && envp != environ) free(envp);
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&fa);
+    free(cmd.owned);
+
+    if (res != 0) {
+        errno = res;
+        return -1;
     }
+    return pid;
 }
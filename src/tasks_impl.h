@@ -3,7 +3,31 @@
 
 #include "task.h"
 
-//Execution de la tâche en fonction de son type dans le fils
-void execute_task(Task *t);
+//Execution de la tâche en fonction de son type dans le fils ;
+//stdout/stderr vont sur out_fd (ou dans le journal si out_fd < 0)
+void execute_task(Task *t, int out_fd);
+
+//Crée le processus de la tâche au moment du lancement (posix_spawn) ;
+//retourne son pid, -1 en cas d'échec (errno positionné)
+pid_t spawn_task(const Task *t, int out_fd);
+
+//Mode caché "--run-task" du binaire : exécute la tâche décrite par argv
+//(construit par spawn_task / execute_task) dans le processus courant, pour
+//les tâches sans commande externe. Ne retourne qu'en cas d'arguments invalides.
+int run_task_main(int argc, char **argv);
+
+//Lance ffprobe pour la durée de path ; sa sortie arrive sur *out_fd (tube).
+//Retourne son pid (à récolter par l'appelant), -1 en cas d'échec (errno positionné)
+pid_t probe_media_spawn(const char *path, int *out_fd);
+
+//Durée en secondes lue sur la sortie d'un ffprobe terminé, qui est fermée ;
+//-1 si inconnue
+double probe_media_read(int fd);
+
+//Fichier partiel du segment index pour la sortie out (à libérer)
+char *segment_part_path(const char *out, int index);
+
+//Supprime les fichiers partiels et la liste d'assemblage d'une conversion segmentée
+void segment_cleanup(const Task *t);
 
 #endif // TASKS_IMPL_H
@@ -0,0 +1,150 @@
+// src/trace.c
+#include "trace.h"
+#include "event_loop.h" // monotonic_ns
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#define TRACE_BUF_SIZE (256 * 1024)
+#define TRACE_PARAM_MAX 200 // param1 tronqué dans les arguments des événements
+
+struct Trace {
+    int fd;
+    int pid;
+    long long t0;      // origine des horodatages
+    int first;         // aucun événement écrit
+    size_t len;
+    char buf[TRACE_BUF_SIZE];
+};
+
+
+static void flush(Trace *tr) {
+    size_t off = 0;
+    while (off < tr->len) {
+        ssize_t n = write(tr->fd, tr->buf + off, tr->len - off);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            break; // disque plein : la trace sera tronquée
+        }
+        off += (size_t)n;
+    }
+    tr->len = 0;
+}
+
+// Formate à la suite du tampon, vidé d'abord si la place manque
+static void append(Trace *tr, const char *fmt, ...) {
+    for (int pass = 0; pass < 2; pass++) {
+        size_t room = TRACE_BUF_SIZE - tr->len;
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vsnprintf(tr->buf + tr->len, room, fmt, ap);
+        va_end(ap);
+        if (n < 0) return;
+        if ((size_t)n < room) {
+            tr->len += (size_t)n;
+            return;
+        }
+        flush(tr);
+    }
+}
+
+// Début d'un événement : séparateur puis champs communs
+static void event(Trace *tr, const char *ph, int tid, long long ts_ns) {
+    append(tr, "%s{\"ph\":\"%s\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f", tr->first ? "" : ",\n",
+           ph, tr->pid, tid, (ts_ns - tr->t0) / 1000.0);
+    tr->first = 0;
+}
+
+// Copie JSON de s (guillemets, antislashs et caractères de contrôle échappés)
+static void escape(char *dst, size_t cap, const char *s) {
+    size_t o = 0;
+    for (size_t i = 0; s && s[i] && i < TRACE_PARAM_MAX && o + 7 < cap; i++) {
+        unsigned char c = (unsigned char)s[i];
+        if (c == '"' || c == '\\') {
+            dst[o++] = '\\';
+            dst[o++] = (char)c;
+        } else if (c < 0x20) {
+            o += (size_t)snprintf(dst + o, cap - o, "\\u%04x", c);
+        } else {
+            dst[o++] = (char)c;
+        }
+    }
+    dst[o] = '\0';
+}
+
+static void task_args(Trace *tr, const Task *t) {
+    char param[TRACE_PARAM_MAX * 6 + 8];
+    escape(param, sizeof(param), t->param1);
+    append(tr, "\"id\":%lu,\"pid\":%d,\"prio\":%d,\"param\":\"%s\"", t->id, t->pid, t->priority, param);
+}
+
+static void thread_name(Trace *tr, int tid, const char *name) {
+    append(tr, "%s{\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":\"%s\"}}",
+           tr->first ? "" : ",\n", tr->pid, tid, name);
+    append(tr, ",\n{\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"name\":\"thread_sort_index\","
+               "\"args\":{\"sort_index\":%d}}", tr->pid, tid, tid);
+    tr->first = 0;
+}
+
+Trace *trace_open(const char *path, const char *process_name, int workers) {
+    Trace *tr = malloc(sizeof(Trace));
+    if (!tr) return NULL;
+    tr->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (tr->fd == -1) {
+        free(tr);
+        return NULL;
+    }
+    tr->pid = (int)getpid();
+    tr->t0 = monotonic_ns();
+    tr->first = 1;
+    tr->len = 0;
+
+    char name[TRACE_PARAM_MAX * 6 + 8];
+    append(tr, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    thread_name(tr, 0, "file");
+    for (int i = 0; i < workers; i++) {
+        snprintf(name, sizeof(name), "worker %d", i);
+        thread_name(tr, i + 1, name);
+    }
+    escape(name, sizeof(name), process_name);
+    append(tr, ",\n{\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"name\":\"process_name\",\"args\":{\"name\":\"%s\"}}",
+           tr->pid, name);
+    return tr;
+}
+
+void trace_close(Trace *tr) {
+    if (!tr) return;
+    append(tr, "\n]}\n");
+    flush(tr);
+    close(tr->fd);
+    free(tr);
+}
+
+void trace_slice(Trace *tr, int slot, const Task *t, long long begin_ns, long long end_ns,
+                 const char *why) {
+    if (!tr) return;
+    event(tr, "X", slot + 1, begin_ns);
+    append(tr, ",\"dur\":%.3f,\"cat\":\"task\",\"name\":\"%s #%lu\",\"args\":{",
+           (end_ns - begin_ns) / 1000.0, task_type_names[t->type], t->id);
+    task_args(tr, t);
+    append(tr, ",\"end\":\"%s\"}}", why);
+}
+
+void trace_instant(Trace *tr, int slot, const char *name, long long ts_ns, const Task *t) {
+    if (!tr) return;
+    event(tr, "i", slot + 1, ts_ns);
+    append(tr, ",\"s\":\"t\",\"cat\":\"sched\",\"name\":\"%s\",\"args\":{", name);
+    if (t) task_args(tr, t);
+    append(tr, "}}");
+}
+
+void trace_counter(Trace *tr, long long ts_ns, int running, int queued) {
+    if (!tr) return;
+    event(tr, "C", 0, ts_ns);
+    append(tr, ",\"name\":\"tâches\",\"args\":{\"en cours\":%d,\"en file\":%d}}", running, queued);
+}
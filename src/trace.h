@@ -0,0 +1,32 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "task.h"
+
+//Trace d'ordonnancement au format Chrome trace-event (JSON), lisible par
+//chrome://tracing ou Perfetto : une piste par worker avec une tranche par
+//passage d'une tâche, une piste « file » avec les arrivées et un compteur
+//tâches en cours / en file. Les événements sont formatés dans un tampon
+//vidé par gros blocs ; écrit par le seul thread ordonnanceur.
+typedef struct Trace Trace;
+
+//Crée le fichier (remplacé s'il existe) ; NULL si impossible
+Trace *trace_open(const char *path, const char *process_name, int workers);
+
+//Termine le JSON, vide le tampon et ferme le fichier
+void trace_close(Trace *tr);
+
+//Toutes les fonctions suivantes acceptent tr == NULL (trace désactivée) ;
+//les horodatages viennent de monotonic_ns()
+
+//Passage de t sur le worker slot, de begin_ns à end_ns ; why = fin du passage
+void trace_slice(Trace *tr, int slot, const Task *t, long long begin_ns, long long end_ns,
+                 const char *why);
+
+//Événement ponctuel sur le worker slot (slot < 0 : piste de la file)
+void trace_instant(Trace *tr, int slot, const char *name, long long ts_ns, const Task *t);
+
+//Compteur tâches en cours / en file
+void trace_counter(Trace *tr, long long ts_ns, int running, int queued);
+
+#endif // TRACE_H
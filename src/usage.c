@@ -0,0 +1,136 @@
+// src/usage.c
+#define _GNU_SOURCE
+#include "usage.h"
+#include "log.h"
+
+#include <sys/resource.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>   // sysconf
+
+#define MIB (1024.0 * 1024.0)
+
+
+int usage_read_proc_io(pid_t pid, TaskUsage *u) {
+    char path[32], key[32];
+    unsigned long long value;
+    snprintf(path, sizeof(path), "/proc/%d/io", (int)pid);
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    while (fscanf(f, "%31[^:]: %llu ", key, &value) == 2) {
+        if (strcmp(key, "rchar") == 0) u->rchar = value;
+        else if (strcmp(key, "wchar") == 0) u->wchar = value;
+        else if (strcmp(key, "read_bytes") == 0) u->read_bytes = value;
+        else if (strcmp(key, "write_bytes") == 0) u->write_bytes = value;
+    }
+    fclose(f);
+    return 0;
+}
+
+static long long tv_ns(const struct timeval *tv) {
+    return (long long)tv->tv_sec * 1000000000LL + (long long)tv->tv_usec * 1000LL;
+}
+
+long long usage_cpu_ns(pid_t pid) {
+    char path[32], buf[1024];
+    snprintf(path, sizeof(path), "/proc/%d/stat", (int)pid);
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[n] = '\0';
+    // le nom du programme (2e champ) peut contenir des espaces : repartir de ')'
+    char *p = strrchr(buf, ')');
+    unsigned long long utime, stime;
+    long long cutime, cstime;
+    if (!p || sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu %lld %lld",
+                     &utime, &stime, &cutime, &cstime) != 4) {
+        return -1;
+    }
+    // utime + stime + cutime + cstime : ce que wait4 rendra pour ce fils
+    long long ticks = (long long)(utime + stime) + cutime + cstime;
+    long hz = sysconf(_SC_CLK_TCK);
+    return ticks * (1000000000LL / (hz > 0 ? hz : 100));
+}
+
+void usage_from_rusage(TaskUsage *u, const struct rusage *ru, long long wall_ns) {
+    u->wall_ns = wall_ns;
+    u->user_ns = tv_ns(&ru->ru_utime);
+    u->sys_ns = tv_ns(&ru->ru_stime);
+    u->maxrss_kb = ru->ru_maxrss;
+    u->nvcsw = ru->ru_nvcsw;
+    u->nivcsw = ru->ru_nivcsw;
+}
+
+void usage_add(UsageTotals *tot, const TaskUsage *u, int ok) {
+    tot->tasks++;
+    if (!ok) tot->failed++;
+    tot->sum.wall_ns += u->wall_ns;
+    tot->sum.user_ns += u->user_ns;
+    tot->sum.sys_ns += u->sys_ns;
+    if (u->maxrss_kb > tot->sum.maxrss_kb) tot->sum.maxrss_kb = u->maxrss_kb;
+    tot->sum.nvcsw += u->nvcsw;
+    tot->sum.nivcsw += u->nivcsw;
+    tot->sum.rchar += u->rchar;
+    tot->sum.wchar += u->wchar;
+    tot->sum.read_bytes += u->read_bytes;
+    tot->sum.write_bytes += u->write_bytes;
+}
+
+void usage_log(const char *tag, pid_t pid, const TaskUsage *u) {
+    log_msg("[%s] pid=%d : %.2f s réels, %.2f s user, %.2f s sys, RSS max %.1f Mio, "
+            "cs %ld vol. / %ld invol., E/S %.1f Mio lus / %.1f Mio écrits "
+            "(stockage %.1f / %.1f Mio)",
+            tag, (int)pid, u->wall_ns / 1e9, u->user_ns / 1e9, u->sys_ns / 1e9,
+            u->maxrss_kb / 1024.0, u->nvcsw, u->nivcsw, u->rchar / MIB, u->wchar / MIB,
+            u->read_bytes / MIB, u->write_bytes / MIB);
+}
+
+// Colonnes du bilan : moyennes par tâche, sauf RSS (pic) et E/S (totaux)
+#define TOTALS_HEADER "%-12s %6s %6s %9s %9s %9s %10s %9s %9s %10s %10s"
+#define TOTALS_ROW    "%-12s %6lu %6lu %9.2f %9.2f %9.2f %10.1f %9ld %9ld %10.1f %10.1f"
+
+static int format_row(char *buf, size_t len, int type, const UsageTotals *t) {
+    double n = t->tasks;
+    return snprintf(buf, len, TOTALS_ROW, task_type_labels[type], t->tasks, t->failed,
+                    t->sum.wall_ns / n / 1e9, t->sum.user_ns / n / 1e9, t->sum.sys_ns / n / 1e9,
+                    t->sum.maxrss_kb / 1024.0, (long)(t->sum.nvcsw / n), (long)(t->sum.nivcsw / n),
+                    t->sum.rchar / MIB, t->sum.wchar / MIB);
+}
+
+static int format_header(char *buf, size_t len) {
+    return snprintf(buf, len, TOTALS_HEADER, "Type", "taches", "echecs", "reel(s)", "user(s)",
+                    "sys(s)", "RSSmax(Mi)", "cs vol", "cs invol", "lus(Mi)", "ecrits(Mi)");
+}
+
+static int any_task(const UsageTotals *tot) {
+    for (int i = 0; i < TASK_TYPE_COUNT; i++) {
+        if (tot[i].tasks > 0) return 1;
+    }
+    return 0;
+}
+
+void usage_fprint_totals(FILE *f, const UsageTotals *tot) {
+    if (!any_task(tot)) return;
+    char line[256];
+    format_header(line, sizeof(line));
+    fprintf(f, "===== Consommation par type (moyennes par tâche, E/S totales) =====\n%s\n", line);
+    for (int i = 0; i < TASK_TYPE_COUNT; i++) {
+        if (tot[i].tasks == 0) continue;
+        format_row(line, sizeof(line), i, &tot[i]);
+        fprintf(f, "%s\n", line);
+    }
+}
+
+void usage_log_totals(const UsageTotals *tot) {
+    if (!any_task(tot)) return;
+    char line[256];
+    format_header(line, sizeof(line));
+    log_msg("[Scheduler] Consommation par type (moyennes par tâche, E/S totales)");
+    log_msg("[Scheduler] %s", line);
+    for (int i = 0; i < TASK_TYPE_COUNT; i++) {
+        if (tot[i].tasks == 0) continue;
+        format_row(line, sizeof(line), i, &tot[i]);
+        log_msg("[Scheduler] %s", line);
+    }
+}
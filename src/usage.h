@@ -0,0 +1,41 @@
+#ifndef USAGE_H
+#define USAGE_H
+
+#include <stdio.h>
+#include <sys/types.h>
+#include "task.h"
+
+struct rusage;
+
+//Bilan des tâches terminées d'un même type
+typedef struct {
+    unsigned long tasks; //tâches récoltées
+    unsigned long failed; //dont sorties en erreur ou tuées
+    TaskUsage sum; //sommes (maxrss_kb : plus haut pic observé)
+} UsageTotals;
+
+//Compteurs d'E/S de /proc/<pid>/io ; à lire tant que le fils est un zombie,
+//avant wait4. -1 si le fichier est illisible (u inchangé)
+int usage_read_proc_io(pid_t pid, TaskUsage *u);
+
+//Temps CPU (user + sys) consommé jusqu'ici par un fils vivant, stoppé ou zombie,
+//y compris ses propres fils déjà récoltés, comme le rusage de wait4 (au tic
+//d'horloge près, /proc/<pid>/stat) ; -1 si inconnu
+long long usage_cpu_ns(pid_t pid);
+
+//Reporte le rusage de wait4 et la durée réelle dans u
+void usage_from_rusage(TaskUsage *u, const struct rusage *ru, long long wall_ns);
+
+//Ajoute une tâche au bilan de son type
+void usage_add(UsageTotals *tot, const TaskUsage *u, int ok);
+
+//Une ligne de log pour une tâche
+void usage_log(const char *tag, pid_t pid, const TaskUsage *u);
+
+//Tableau des bilans par type (tot[TASK_TYPE_COUNT]) ; rien si aucune tâche
+void usage_fprint_totals(FILE *f, const UsageTotals *tot);
+
+//Même tableau, ligne par ligne dans le log
+void usage_log_totals(const UsageTotals *tot);
+
+#endif // USAGE_H
@@ -0,0 +1,433 @@
+// src/zstd_engine.c
+#define _POSIX_C_SOURCE 200809L
+#include "zstd_engine.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <pthread.h>
+
+#ifdef HAVE_LIBZSTD
+#include <zstd.h>
+
+struct ZstdWriter {
+    ZSTD_CCtx *cctx;
+    int fd;
+    int failed;
+    ZSTD_outBuffer out;
+};
+
+int zstd_engine_available(void) {
+    return 1;
+}
+
+static int write_all(int fd, const void *buf, size_t len) {
+    const char *p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// Fait avancer la compression et vide le tampon de sortie ; retourne ce qu'il
+// reste à vider dans zstd (0 = tout est sorti), ou (size_t)-1 en cas d'erreur
+static size_t writer_step(ZstdWriter *w, ZSTD_inBuffer *in, ZSTD_EndDirective mode) {
+    w->out.pos = 0;
+    size_t rem = ZSTD_compressStream2(w->cctx, &w->out, in, mode);
+    if (ZSTD_isError(rem)) {
+        fprintf(stderr, "[zstd] %s\n", ZSTD_getErrorName(rem));
+        return (size_t)-1;
+    }
+    if (w->out.pos > 0 && write_all(w->fd, w->out.dst, w->out.pos) == -1) {
+        fprintf(stderr, "[zstd] écriture: %s\n", strerror(errno));
+        return (size_t)-1;
+    }
+    return rem;
+}
+
+ZstdWriter *zstd_writer_open(int out_fd, int level, int threads,
+                             unsigned long long content_size) {
+    ZstdWriter *w = calloc(1, sizeof(ZstdWriter));
+    if (!w) return NULL;
+    w->fd = out_fd;
+    w->cctx = ZSTD_createCCtx();
+    w->out.dst = malloc(ZSTD_ENGINE_BUF_SIZE);
+    w->out.size = ZSTD_ENGINE_BUF_SIZE;
+    if (!w->cctx || !w->out.dst) {
+        ZSTD_freeCCtx(w->cctx);
+        free(w->out.dst);
+        free(w);
+        return NULL;
+    }
+    if (threads <= 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = n > 0 ? (int)n : 1;
+    }
+    ZSTD_CCtx_setParameter(w->cctx, ZSTD_c_compressionLevel, level);
+    ZSTD_CCtx_setParameter(w->cctx, ZSTD_c_checksumFlag, 1);
+    // nbWorkers >= 1 : compression multithread (ignoré si libzstd sans ZSTD_MULTITHREAD)
+    if (threads > 1) {
+        ZSTD_CCtx_setParameter(w->cctx, ZSTD_c_nbWorkers, threads);
+    }
+    if (content_size > 0) {
+        ZSTD_CCtx_setPledgedSrcSize(w->cctx, content_size);
+    }
+    return w;
+}
+
+int zstd_writer_write(ZstdWriter *w, const void *data, size_t len) {
+    if (w->failed) return -1;
+    ZSTD_inBuffer in = { data, len, 0 };
+    while (in.pos < in.size) {
+        if (writer_step(w, &in, ZSTD_e_continue) == (size_t)-1) {
+            w->failed = 1;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int zstd_writer_close(ZstdWriter *w) {
+    int res = w->failed ? -1 : 0;
+    if (res == 0) {
+        ZSTD_inBuffer in = { NULL, 0, 0 };
+        size_t rem;
+        do {
+            rem = writer_step(w, &in, ZSTD_e_end);
+        } while (rem != 0 && rem != (size_t)-1);
+        if (rem != 0) res = -1;
+    }
+    ZSTD_freeCCtx(w->cctx);
+    free(w->out.dst);
+    free(w);
+    return res;
+}
+
+int zstd_compress_file(const char *in_path, const char *out_path, int level, int threads) {
+    int in_fd = open(in_path, O_RDONLY | O_CLOEXEC);
+    if (in_fd == -1) {
+        fprintf(stderr, "[zstd] %s: %s\n", in_path, strerror(errno));
+        return -1;
+    }
+    struct stat st;
+    unsigned long long size = 0;
+    if (fstat(in_fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        size = (unsigned long long)st.st_size;
+    }
+    posix_fadvise(in_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    int out_fd = open(out_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out_fd == -1) {
+        fprintf(stderr, "[zstd] %s: %s\n", out_path, strerror(errno));
+        close(in_fd);
+        return -1;
+    }
+
+    char *buf = malloc(ZSTD_ENGINE_BUF_SIZE);
+    ZstdWriter *w = buf ? zstd_writer_open(out_fd, level, threads, size) : NULL;
+    int res = w ? 0 : -1;
+    unsigned long long total = 0;
+    while (res == 0) {
+        ssize_t n = read(in_fd, buf, ZSTD_ENGINE_BUF_SIZE);
+        if (n == 0) break;
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "[zstd] lecture %s: %s\n", in_path, strerror(errno));
+            res = -1;
+            break;
+        }
+        total += (unsigned long long)n;
+        res = zstd_writer_write(w, buf, (size_t)n);
+    }
+    if (w && zstd_writer_close(w) == -1) res = -1;
+    if (close(out_fd) == -1) res = -1;
+    close(in_fd);
+    free(buf);
+
+    if (res == -1) {
+        unlink(out_path);
+        return -1;
+    }
+    struct stat ost;
+    if (stat(out_path, &ost) == 0) {
+        fprintf(stderr, "%s : %llu -> %lld octets (%.2f%%, niveau %d)\n", in_path, total,
+               (long long)ost.st_size, total ? 100.0 * ost.st_size / total : 0.0, level);
+    }
+    return 0;
+}
+
+
+// ====== Format seekable ======
+#define SEEKABLE_SKIPPABLE_MAGIC 0x184D2A5EU
+#define SEEKABLE_MAGIC 0x8F92EAB1U
+
+// Trame en cours de compression ; le slot i traite les trames i, i + nslots, ...
+typedef struct {
+    long index;               // trame portée par le slot (-1 : libre)
+    int done;
+    size_t in_len;
+    size_t out_len;
+    char *in;
+    char *out;
+} SeekSlot;
+
+typedef struct {
+    pthread_mutex_t mu;
+    pthread_cond_t cv;
+    int in_fd;
+    int level;
+    size_t frame_size;
+    size_t out_cap;
+    long nframes;
+    long next;                // prochaine trame à prendre
+    int failed;
+    int nslots;
+    SeekSlot *slots;
+} SeekJob;
+
+static void *seek_worker(void *arg) {
+    SeekJob *job = arg;
+    ZSTD_CCtx *cctx = ZSTD_createCCtx();
+    if (cctx) {
+        ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, job->level);
+        ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, 1);
+    }
+
+    pthread_mutex_lock(&job->mu);
+    while (!job->failed && job->next < job->nframes) {
+        long idx = job->next;
+        SeekSlot *slot = &job->slots[idx % job->nslots];
+        if (slot->index != -1) {
+            // slot encore occupé par la trame idx - nslots (pas encore écrite)
+            pthread_cond_wait(&job->cv, &job->mu);
+            continue;
+        }
+        job->next++;
+        slot->index = idx;
+        slot->done = 0;
+        pthread_mutex_unlock(&job->mu);
+
+        int ok = cctx != NULL;
+        size_t got = 0;
+        off_t off = (off_t)idx * (off_t)job->frame_size;
+        while (ok && got < job->frame_size) {
+            ssize_t n = pread(job->in_fd, slot->in + got, job->frame_size - got, off + (off_t)got);
+            if (n == -1 && errno == EINTR) continue;
+            if (n == -1) {
+                fprintf(stderr, "[zstd] lecture: %s\n", strerror(errno));
+                ok = 0;
+            }
+            if (n <= 0) break;
+            got += (size_t)n;
+        }
+        size_t res = 0;
+        if (ok) {
+            res = ZSTD_compress2(cctx, slot->out, job->out_cap, slot->in, got);
+            if (ZSTD_isError(res)) {
+                fprintf(stderr, "[zstd] %s\n", ZSTD_getErrorName(res));
+                ok = 0;
+            }
+        }
+
+        pthread_mutex_lock(&job->mu);
+        slot->in_len = got;
+        slot->out_len = res;
+        slot->done = 1;
+        if (!ok) job->failed = 1;
+        pthread_cond_broadcast(&job->cv);
+    }
+    pthread_mutex_unlock(&job->mu);
+    ZSTD_freeCCtx(cctx);
+    return NULL;
+}
+
+static void put_le32(unsigned char *p, unsigned v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+int zstd_compress_seekable(const char *in_path, const char *out_path, int level,
+                           int threads, size_t frame_size) {
+    if (frame_size == 0 || frame_size > ZSTD_SEEKABLE_MAX_FRAME) {
+        fprintf(stderr, "[zstd] taille de trame invalide: %zu\n", frame_size);
+        return -1;
+    }
+    if (threads <= 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = n > 0 ? (int)n : 1;
+    }
+    int in_fd = open(in_path, O_RDONLY | O_CLOEXEC);
+    if (in_fd == -1) {
+        fprintf(stderr, "[zstd] %s: %s\n", in_path, strerror(errno));
+        return -1;
+    }
+    struct stat st;
+    if (fstat(in_fd, &st) == -1 || !S_ISREG(st.st_mode)) {
+        fprintf(stderr, "[zstd] %s: fichier régulier attendu\n", in_path);
+        close(in_fd);
+        return -1;
+    }
+    int out_fd = open(out_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out_fd == -1) {
+        fprintf(stderr, "[zstd] %s: %s\n", out_path, strerror(errno));
+        close(in_fd);
+        return -1;
+    }
+
+    // une seule trame : pas de tampon plus grand que le fichier
+    if (st.st_size > 0 && (off_t)frame_size > st.st_size) frame_size = (size_t)st.st_size;
+
+    SeekJob job;
+    memset(&job, 0, sizeof(job));
+    pthread_mutex_init(&job.mu, NULL);
+    pthread_cond_init(&job.cv, NULL);
+    job.in_fd = in_fd;
+    job.level = level;
+    job.frame_size = frame_size;
+    job.out_cap = ZSTD_compressBound(frame_size);
+    job.nframes = st.st_size > 0 ? (long)((st.st_size + (off_t)frame_size - 1) / (off_t)frame_size) : 1;
+    // de quoi compresser pendant que la trame suivante s'écrit, sans dépasser
+    // le nombre de trames ni le budget mémoire
+    long budget = (long)(ZSTD_SEEKABLE_MEM_BUDGET / (frame_size + job.out_cap));
+    job.nslots = 2 * threads;
+    if (job.nslots > job.nframes) job.nslots = (int)job.nframes;
+    if (job.nslots > budget) job.nslots = (int)budget;
+    if (job.nslots < 1) job.nslots = 1;
+    if (threads > job.nslots) threads = job.nslots;
+    job.slots = calloc((size_t)job.nslots, sizeof(SeekSlot));
+
+    // Table de saut : 8 octets par trame + pied de 9 octets
+    unsigned char *table = malloc(8 + (size_t)job.nframes * 8 + 9);
+    int res = job.slots && table ? 0 : -1;
+    for (int i = 0; res == 0 && i < job.nslots; i++) {
+        job.slots[i].index = -1;
+        job.slots[i].in = malloc(frame_size);
+        job.slots[i].out = malloc(job.out_cap);
+        if (!job.slots[i].in || !job.slots[i].out) res = -1;
+    }
+    if (res == -1) fprintf(stderr, "[zstd] plus de mémoire\n");
+
+    pthread_t *tids = res == 0 ? malloc((size_t)threads * sizeof(pthread_t)) : NULL;
+    int started = 0;
+    for (; tids && started < threads; started++) {
+        if (pthread_create(&tids[started], NULL, seek_worker, &job) != 0) break;
+    }
+    if (res == 0 && started == 0) res = -1;
+
+    // Écriture des trames dans l'ordre
+    unsigned long long total_in = 0, total_out = 0;
+    size_t tpos = 8;
+    for (long idx = 0; res == 0 && idx < job.nframes; idx++) {
+        SeekSlot *slot = &job.slots[idx % job.nslots];
+        pthread_mutex_lock(&job.mu);
+        while (!job.failed && !(slot->index == idx && slot->done)) {
+            pthread_cond_wait(&job.cv, &job.mu);
+        }
+        int failed = job.failed;
+        pthread_mutex_unlock(&job.mu);
+        if (failed) {
+            res = -1;
+            break;
+        }
+        if (write_all(out_fd, slot->out, slot->out_len) == -1) {
+            fprintf(stderr, "[zstd] écriture: %s\n", strerror(errno));
+            res = -1;
+        }
+        put_le32(table + tpos, (unsigned)slot->out_len);
+        put_le32(table + tpos + 4, (unsigned)slot->in_len);
+        tpos += 8;
+        total_in += slot->in_len;
+        total_out += slot->out_len;
+
+        pthread_mutex_lock(&job.mu);
+        slot->index = -1;
+        if (res == -1) job.failed = 1;
+        pthread_cond_broadcast(&job.cv);
+        pthread_mutex_unlock(&job.mu);
+    }
+
+    pthread_mutex_lock(&job.mu);
+    if (res == -1) job.failed = 1;
+    pthread_cond_broadcast(&job.cv);
+    pthread_mutex_unlock(&job.mu);
+    for (int i = 0; i < started; i++) pthread_join(tids[i], NULL);
+    free(tids);
+
+    if (res == 0) {
+        // Trame skippable : magic, taille, entrées, puis pied (nb trames, descripteur, magic)
+        put_le32(table, SEEKABLE_SKIPPABLE_MAGIC);
+        put_le32(table + 4, (unsigned)(tpos - 8 + 9));
+        put_le32(table + tpos, (unsigned)job.nframes);
+        table[tpos + 4] = 0; // pas de somme de contrôle par trame dans la table
+        put_le32(table + tpos + 5, SEEKABLE_MAGIC);
+        if (write_all(out_fd, table, tpos + 9) == -1) res = -1;
+    }
+
+    for (int i = 0; job.slots && i < job.nslots; i++) {
+        free(job.slots[i].in);
+        free(job.slots[i].out);
+    }
+    free(job.slots);
+    free(table);
+    pthread_cond_destroy(&job.cv);
+    pthread_mutex_destroy(&job.mu);
+    if (close(out_fd) == -1) res = -1;
+    close(in_fd);
+
+    if (res == -1) {
+        unlink(out_path);
+        return -1;
+    }
+    fprintf(stderr, "%s : %llu -> %llu octets en %ld trame(s) seekable de %zu octets (niveau %d, %d thread(s))\n",
+            in_path, total_in, total_out, job.nframes, frame_size, level, threads);
+    return 0;
+}
+
+#else // !HAVE_LIBZSTD
+
+int zstd_engine_available(void) {
+    return 0;
+}
+
+ZstdWriter *zstd_writer_open(int out_fd, int level, int threads,
+                             unsigned long long content_size) {
+    (void)out_fd; (void)level; (void)threads; (void)content_size;
+    errno = ENOSYS;
+    return NULL;
+}
+
+int zstd_writer_write(ZstdWriter *w, const void *data, size_t len) {
+    (void)w; (void)data; (void)len;
+    return -1;
+}
+
+int zstd_writer_close(ZstdWriter *w) {
+    (void)w;
+    return -1;
+}
+
+int zstd_compress_file(const char *in_path, const char *out_path, int level, int threads) {
+    (void)out_path; (void)level; (void)threads;
+    fprintf(stderr, "[zstd] %s : compilé sans libzstd\n", in_path);
+    return -1;
+}
+
+int zstd_compress_seekable(const char *in_path, const char *out_path, int level,
+                           int threads, size_t frame_size) {
+    (void)frame_size;
+    return zstd_compress_file(in_path, out_path, level, threads);
+}
+
+#endif // HAVE_LIBZSTD
@@ -0,0 +1,43 @@
+#ifndef ZSTD_ENGINE_H
+#define ZSTD_ENGINE_H
+
+#include <stddef.h>
+
+//Compression zstd dans le processus (libzstd), sans fork+exec de l'outil zstd.
+//Disponible seulement si compilé avec HAVE_LIBZSTD (make WITH_ZSTD=1).
+
+#define ZSTD_ENGINE_BUF_SIZE (4 * 1024 * 1024) //tampons de lecture / écriture
+
+//1 si la compression dans le processus est disponible
+int zstd_engine_available(void);
+
+//Flux de compression vers un descripteur : une trame zstd unique
+typedef struct ZstdWriter ZstdWriter;
+
+//threads = 0 : un thread de compression par CPU en ligne ;
+//content_size = taille totale si connue (écrite dans l'en-tête), sinon 0
+ZstdWriter *zstd_writer_open(int out_fd, int level, int threads,
+                             unsigned long long content_size);
+int zstd_writer_write(ZstdWriter *w, const void *data, size_t len);
+
+//Termine la trame, écrit tout et libère (0 si ok, -1 sinon)
+int zstd_writer_close(ZstdWriter *w);
+
+//Compresse le fichier in_path dans out_path (0 si ok, -1 sinon ; message sur stderr)
+int zstd_compress_file(const char *in_path, const char *out_path, int level, int threads);
+
+//Format seekable zstd : le fichier est découpé en trames indépendantes de
+//frame_size octets, compressées en parallèle par `threads` threads, puis
+//suivies d'une table de saut (trame « skippable », magic 0x8F92EAB1) qui
+//permet la décompression par morceaux / en parallèle. Lisible par zstd -d.
+//Chaque trame en vol immobilise frame_size octets d'entrée et autant de
+//sortie : le nombre de trames en vol (au plus 2 par thread) est borné par
+//ZSTD_SEEKABLE_MEM_BUDGET, et les threads en trop ne sont pas créés.
+#define ZSTD_SEEKABLE_MAX_FRAME_MB 256
+#define ZSTD_SEEKABLE_MAX_FRAME ((size_t)ZSTD_SEEKABLE_MAX_FRAME_MB * 1024 * 1024)
+#define ZSTD_SEEKABLE_MEM_BUDGET ((size_t)1024 * 1024 * 1024) //tampons de toutes les trames en vol
+
+int zstd_compress_seekable(const char *in_path, const char *out_path, int level,
+                           int threads, size_t frame_size);
+
+#endif // ZSTD_ENGINE_H